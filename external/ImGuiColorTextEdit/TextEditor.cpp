@@ -1,8 +1,12 @@
 #include <algorithm>
+#include <array>
 #include <chrono>
+#include <numeric>
 #include <string>
 #include <regex>
 #include <cmath>
+#include <cstring>
+#include <thread>
 
 #include "TextEditor.h"
 
@@ -30,6 +34,9 @@ bool equals(InputIt1 first1, InputIt1 last1,
 TextEditor::TextEditor()
 	: mLineSpacing(1.0f)
 	, mUndoIndex(0)
+	, mUndoMemory(0)
+	, mUndoMemoryBudget(32 * 1024 * 1024)
+	, mUndoMergeable(false)
 	, mTabSize(4)
 	, mOverwrite(false)
 	, mReadOnly(false)
@@ -37,14 +44,25 @@ TextEditor::TextEditor()
 	, mScrollToCursor(false)
 	, mScrollToTop(false)
 	, mTextChanged(false)
+	, mGlyphCount(0)
+	, mCharCount(0)
+	, mTextGeneration(0)
 	, mColorizerEnabled(true)
+	, mColorizeBudget(4.0f)
 	, mTextStart(20.0f)
 	, mLeftMargin(10)
 	, mCursorPositionChanged(false)
-	, mColorRangeMin(0)
-	, mColorRangeMax(0)
+	, mScanFrom(std::numeric_limits<int>::max())
+	, mScanTo(0)
+	, mColorizeFrom(std::numeric_limits<int>::max())
+	, mFirstVisibleLine(0)
+	, mLastVisibleLine(0)
+	, mFont(nullptr)
+	, mFontSize(0.0f)
+	, mSpaceSize(0.0f)
+	, mTextStartLines(-1)
+	, mPaletteAlpha(-1.0f)
 	, mSelectionMode(SelectionMode::Normal)
-	, mCheckComments(true)
 	, mLastClick(-1.0f)
 	, mHandleKeyboardInputs(true)
 	, mHandleMouseInputs(true)
@@ -52,8 +70,10 @@ TextEditor::TextEditor()
 	, mShowWhitespaces(true)
 	, mStartTime(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count())
 {
+	// the default language is built once for all the editors
+	static const SharedLanguage DefaultLanguage = BuildLanguage(LanguageDefinition::HLSL());
 	SetPalette(GetDarkPalette());
-	SetLanguageDefinition(LanguageDefinition::HLSL());
+	SetLanguage(DefaultLanguage);
 	mLines.push_back(Line());
 }
 
@@ -61,20 +81,37 @@ TextEditor::~TextEditor()
 {
 }
 
-void TextEditor::SetLanguageDefinition(const LanguageDefinition & aLanguageDef)
+TextEditor::SharedLanguage TextEditor::BuildLanguage(const LanguageDefinition & aLanguageDef)
 {
-	mLanguageDefinition = aLanguageDef;
-	mRegexList.clear();
+	auto language = std::make_shared<Language>();
+	language->mDefinition = aLanguageDef;
+	for (auto& r : aLanguageDef.mTokenRegexStrings)
+		language->mRegexList.push_back(std::make_pair(std::regex(r.first, std::regex_constants::optimize), r.second));
+	language->mWordTable.Build(aLanguageDef);
+	return language;
+}
 
-	for (auto& r : mLanguageDefinition.mTokenRegexStrings)
-		mRegexList.push_back(std::make_pair(std::regex(r.first, std::regex_constants::optimize), r.second));
+void TextEditor::SetLanguageDefinition(const LanguageDefinition & aLanguageDef)
+{
+	SetLanguage(BuildLanguage(aLanguageDef));
+}
 
+void TextEditor::SetLanguage(SharedLanguage aLanguage)
+{
+	assert(aLanguage != nullptr);
+	mLanguage = std::move(aLanguage);
 	Colorize();
 }
 
+const TextEditor::LanguageDefinition& TextEditor::GetLanguageDefinition() const
+{
+	return mLanguage->mDefinition;
+}
+
 void TextEditor::SetPalette(const Palette & aValue)
 {
 	mPaletteBase = aValue;
+	mPaletteAlpha = -1.0f;
 }
 
 std::string TextEditor::GetText(const Coordinates & aStart, const Coordinates & aEnd) const
@@ -146,6 +183,11 @@ TextEditor::Coordinates TextEditor::SanitizeCoordinates(const Coordinates & aVal
 
 // https://en.wikipedia.org/wiki/UTF-8
 // We assume that the char is a standalone character (<128) or a leading byte of an UTF-8 code sequence (non-10xxxxxx code)
+static bool IsUTFSequence(char c)
+{
+	return (c & 0xC0) == 0x80;
+}
+
 static int UTF8CharLength(TextEditor::Char c)
 {
 	if ((c & 0xFE) == 0xFC)
@@ -238,20 +280,32 @@ void TextEditor::DeleteRange(const Coordinates & aStart, const Coordinates & aEn
 		auto& line = mLines[aStart.mLine];
 		auto n = GetLineMaxColumn(aStart.mLine);
 		if (aEnd.mColumn >= n)
+		{
+			CountGlyphs(line, start, (int)line.size(), -1);
 			line.erase(line.begin() + start, line.end());
+		}
 		else
+		{
+			CountGlyphs(line, start, end, -1);
 			line.erase(line.begin() + start, line.begin() + end);
+		}
 	}
 	else
 	{
 		auto& firstLine = mLines[aStart.mLine];
 		auto& lastLine = mLines[aEnd.mLine];
 
+		CountGlyphs(firstLine, start, (int)firstLine.size(), -1);
 		firstLine.erase(firstLine.begin() + start, firstLine.end());
+		CountGlyphs(lastLine, 0, end, -1);
 		lastLine.erase(lastLine.begin(), lastLine.begin() + end);
 
 		if (aStart.mLine < aEnd.mLine)
+		{
+			// copied, the last line being removed below
+			CountGlyphs(lastLine, 0, (int)lastLine.size(), 1);
 			firstLine.insert(firstLine.end(), lastLine.begin(), lastLine.end());
+		}
 
 		if (aStart.mLine < aEnd.mLine)
 			RemoveLine(aStart.mLine + 1, aEnd.mLine + 1);
@@ -263,48 +317,58 @@ void TextEditor::DeleteRange(const Coordinates & aStart, const Coordinates & aEn
 int TextEditor::InsertTextAt(Coordinates& /* inout */ aWhere, const char * aValue)
 {
 	assert(!mReadOnly);
+	assert(!mLines.empty());
+
+	if (*aValue == '\0')
+		return 0;
 
-	int cindex = GetCharacterIndex(aWhere);
-	int totalLines = 0;
-	while (*aValue != '\0')
+	// The text is split into lines first, then spliced in one go:
+	// pasting a large block shifts the following lines once, not once per line and per character
+	Lines inserted(1);
+	int lastColumns = 0; // characters of the last inserted line
+	for (auto p = aValue; *p != '\0'; ++p)
 	{
-		assert(!mLines.empty());
+		if (*p == '\r')
+			continue;
 
-		if (*aValue == '\r')
-		{
-			// skip
-			++aValue;
-		}
-		else if (*aValue == '\n')
+		if (*p == '\n')
 		{
-			if (cindex < (int)mLines[aWhere.mLine].size())
-			{
-				auto& newLine = InsertLine(aWhere.mLine + 1);
-				auto& line = mLines[aWhere.mLine];
-				newLine.insert(newLine.begin(), line.begin() + cindex, line.end());
-				line.erase(line.begin() + cindex, line.end());
-			}
-			else
-			{
-				InsertLine(aWhere.mLine + 1);
-			}
-			++aWhere.mLine;
-			aWhere.mColumn = 0;
-			cindex = 0;
-			++totalLines;
-			++aValue;
+			inserted.emplace_back(Line());
+			lastColumns = 0;
 		}
 		else
 		{
-			auto& line = mLines[aWhere.mLine];
-			auto d = UTF8CharLength(*aValue);
-			while (d-- > 0 && *aValue != '\0')
-				line.insert(line.begin() + cindex++, Glyph(*aValue++, PaletteIndex::Default));
-			++aWhere.mColumn;
+			if (!IsUTFSequence(*p))
+				++lastColumns;
+			inserted.back().emplace_back(Glyph(*p, PaletteIndex::Default));
 		}
+	}
+	for (auto& newLine : inserted)
+		CountGlyphs(newLine, 0, (int)newLine.size(), 1);
 
-		mTextChanged = true;
+	const int totalLines = (int)inserted.size() - 1;
+	const int cindex = GetCharacterIndex(aWhere);
+	auto& line = mLines[aWhere.mLine];
+	if (totalLines > 0)
+	{
+		// the end of the line follows the inserted text: the counts do not change
+		auto& lastLine = inserted.back();
+		lastLine.insert(lastLine.end(), line.begin() + cindex, line.end());
+		line.erase(line.begin() + cindex, line.end());
+	}
+	line.insert(line.begin() + cindex, inserted.front().begin(), inserted.front().end());
+
+	if (totalLines > 0)
+	{
+		InsertLines(aWhere.mLine + 1, totalLines);
+		std::move(inserted.begin() + 1, inserted.end(), mLines.begin() + aWhere.mLine + 1);
+		aWhere.mLine += totalLines;
+		aWhere.mColumn = lastColumns;
 	}
+	else
+		aWhere.mColumn += lastColumns;
+
+	mTextChanged = true;
 
 	return totalLines;
 }
@@ -319,9 +383,71 @@ void TextEditor::AddUndo(UndoRecord& aValue)
 	//	aValue.mAfter.mCursorPosition.mLine, aValue.mAfter.mCursorPosition.mColumn
 	//	);
 
-	mUndoBuffer.resize((size_t)(mUndoIndex + 1));
-	mUndoBuffer.back() = aValue;
+	// the records after the current one cannot be redone any more
+	while ((int)mUndoBuffer.size() > mUndoIndex)
+	{
+		mUndoMemory -= mUndoBuffer.back().GetMemorySize();
+		mUndoBuffer.pop_back();
+	}
+
+	// consecutive keystrokes are undone together, until the cursor is moved in between
+	const bool isKeystroke = aValue.IsKeystroke();
+	if (isKeystroke && mUndoMergeable && !mUndoBuffer.empty())
+	{
+		auto& last = mUndoBuffer.back();
+		const auto lastSize = last.GetMemorySize();
+		if (last.Merge(aValue))
+		{
+			mUndoMemory = mUndoMemory - lastSize + last.GetMemorySize();
+			EnforceUndoMemoryBudget();
+			return;
+		}
+	}
+
+	mUndoMergeable = isKeystroke;
+	aValue.Share(mUndoArena);
+	mUndoBuffer.push_back(std::move(aValue));
+	mUndoMemory += mUndoBuffer.back().GetMemorySize();
 	++mUndoIndex;
+
+	EnforceUndoMemoryBudget();
+}
+
+void TextEditor::EnforceUndoMemoryBudget()
+{
+	// the arena is measured once, then the texts released by each evicted record are deducted
+	size_t arenaSize = mUndoArena.GetSize();
+	auto evict = [this, &arenaSize](UndoRecord& aRecord)
+	{
+		mUndoMemory -= aRecord.GetMemorySize();
+		arenaSize -= std::min(arenaSize, aRecord.GetReleasedSize());
+	};
+
+	// the records undone first: the oldest ones are still applied to the text, a redo needs all the ones before it
+	while ((int)mUndoBuffer.size() > mUndoIndex && mUndoMemory + arenaSize > mUndoMemoryBudget)
+	{
+		evict(mUndoBuffer.back());
+		mUndoBuffer.pop_back();
+	}
+
+	// then the oldest ones, the last one is kept whatever its size
+	while (mUndoIndex > 1 && mUndoMemory + arenaSize > mUndoMemoryBudget)
+	{
+		evict(mUndoBuffer.front());
+		mUndoBuffer.pop_front();
+		--mUndoIndex;
+	}
+}
+
+void TextEditor::SetUndoMemoryBudget(size_t aBytes)
+{
+	mUndoMemoryBudget = aBytes;
+	EnforceUndoMemoryBudget();
+}
+
+size_t TextEditor::GetUndoMemoryUsage()
+{
+	return mUndoMemory + mUndoArena.GetSize();
 }
 
 TextEditor::Coordinates TextEditor::ScreenPosToCoordinates(const ImVec2& aPosition) const
@@ -600,8 +726,20 @@ void TextEditor::RemoveLine(int aStart, int aEnd)
 	}
 	mBreakpoints = std::move(btmp);
 
+	for (int i = aStart; i < aEnd; ++i)
+		CountGlyphs(mLines[i], 0, (int)mLines[i].size(), -1);
+	if (mLineStates.size() == mLines.size() + 1)
+	{
+		mLineStates.erase(mLineStates.begin() + aStart, mLineStates.begin() + aEnd);
+		mLineColorized.erase(mLineColorized.begin() + aStart, mLineColorized.begin() + aEnd);
+		mLineWidths.erase(mLineWidths.begin() + aStart, mLineWidths.begin() + aEnd);
+		mScanTo = mScanTo > aEnd ? mScanTo - (aEnd - aStart) : std::min(mScanTo, aStart);
+		mScanFrom = std::min(mScanFrom, std::max(0, aStart - 1));
+		mScanTo = std::max(mScanTo, aStart + 1);
+	}
 	mLines.erase(mLines.begin() + aStart, mLines.begin() + aEnd);
 	assert(!mLines.empty());
+	++mTextGeneration;
 
 	mTextChanged = true;
 }
@@ -630,26 +768,88 @@ void TextEditor::RemoveLine(int aIndex)
 	}
 	mBreakpoints = std::move(btmp);
 
+	CountGlyphs(mLines[aIndex], 0, (int)mLines[aIndex].size(), -1);
+	if (mLineStates.size() == mLines.size() + 1)
+	{
+		mLineStates.erase(mLineStates.begin() + aIndex);
+		mLineColorized.erase(mLineColorized.begin() + aIndex);
+		mLineWidths.erase(mLineWidths.begin() + aIndex);
+		mScanTo = mScanTo > aIndex ? mScanTo - 1 : mScanTo;
+		mScanFrom = std::min(mScanFrom, std::max(0, aIndex - 1));
+		mScanTo = std::max(mScanTo, aIndex + 1);
+	}
 	mLines.erase(mLines.begin() + aIndex);
 	assert(!mLines.empty());
+	++mTextGeneration;
 
 	mTextChanged = true;
 }
 
+void TextEditor::CountGlyph(char aChar, int aDelta)
+{
+	// a UTF-8 character is counted on its first byte
+	const bool isFirstByte = (aChar & 0xC0) != 0x80;
+	if (aDelta > 0)
+	{
+		++mGlyphCount;
+		mCharCount += isFirstByte ? 1 : 0;
+	}
+	else
+	{
+		--mGlyphCount;
+		mCharCount -= isFirstByte ? 1 : 0;
+	}
+	++mTextGeneration;
+}
+
+void TextEditor::CountGlyphs(const Line& aLine, int aStart, int aEnd, int aDelta)
+{
+	for (int i = aStart; i < aEnd; ++i)
+		CountGlyph(aLine[i].mChar, aDelta);
+}
+
+void TextEditor::RecountText()
+{
+	mGlyphCount = 0;
+	mCharCount = 0;
+	for (auto& line : mLines)
+		CountGlyphs(line, 0, (int)line.size(), 1);
+	++mTextGeneration;
+}
+
 TextEditor::Line& TextEditor::InsertLine(int aIndex)
+{
+	return InsertLines(aIndex, 1);
+}
+
+TextEditor::Line& TextEditor::InsertLines(int aIndex, int aCount)
 {
 	assert(!mReadOnly);
+	assert(aCount > 0);
 
-	auto& result = *mLines.insert(mLines.begin() + aIndex, Line());
+	// the new lines start the way the one they push down used to
+	if (mLineStates.size() == mLines.size() + 1)
+	{
+		const auto state = mLineStates[aIndex];
+		mLineStates.insert(mLineStates.begin() + aIndex, aCount, state);
+		mLineColorized.insert(mLineColorized.begin() + aIndex, aCount, false);
+		mLineWidths.insert(mLineWidths.begin() + aIndex, aCount, -1.0f);
+		mScanTo = mScanTo > aIndex ? mScanTo + aCount : mScanTo;
+		mScanFrom = std::min(mScanFrom, aIndex);
+		mScanTo = std::max(mScanTo, aIndex + aCount);
+		mColorizeFrom = std::min(mColorizeFrom, aIndex);
+	}
+	auto& result = *mLines.insert(mLines.begin() + aIndex, aCount, Line());
+	++mTextGeneration;
 
 	ErrorMarkers etmp;
 	for (auto& i : mErrorMarkers)
-		etmp.insert(ErrorMarkers::value_type(i.first >= aIndex ? i.first + 1 : i.first, i.second));
+		etmp.insert(ErrorMarkers::value_type(i.first >= aIndex ? i.first + aCount : i.first, i.second));
 	mErrorMarkers = std::move(etmp);
 
 	Breakpoints btmp;
 	for (auto i : mBreakpoints)
-		btmp.insert(i >= aIndex ? i + 1 : i);
+		btmp.insert(i >= aIndex ? i + aCount : i);
 	mBreakpoints = std::move(btmp);
 
 	return result;
@@ -802,6 +1002,7 @@ void TextEditor::HandleMouseInputs()
 			{
 				if (!ctrl)
 				{
+					mUndoMergeable = false;
 					mState.mCursorPosition = mInteractiveStart = mInteractiveEnd = ScreenPosToCoordinates(ImGui::GetMousePos());
 					mSelectionMode = SelectionMode::Line;
 					SetSelection(mInteractiveStart, mInteractiveEnd, mSelectionMode);
@@ -818,6 +1019,7 @@ void TextEditor::HandleMouseInputs()
 			{
 				if (!ctrl)
 				{
+					mUndoMergeable = false;
 					mState.mCursorPosition = mInteractiveStart = mInteractiveEnd = ScreenPosToCoordinates(ImGui::GetMousePos());
 					if (mSelectionMode == SelectionMode::Line)
 						mSelectionMode = SelectionMode::Normal;
@@ -834,6 +1036,7 @@ void TextEditor::HandleMouseInputs()
 			*/
 			else if (click)
 			{
+				mUndoMergeable = false;
 				mState.mCursorPosition = mInteractiveStart = mInteractiveEnd = ScreenPosToCoordinates(ImGui::GetMousePos());
 				if (ctrl)
 					mSelectionMode = SelectionMode::Word;
@@ -847,6 +1050,7 @@ void TextEditor::HandleMouseInputs()
 			else if (ImGui::IsMouseDragging(0) && ImGui::IsMouseDown(0))
 			{
 				io.WantCaptureMouse = true;
+				mUndoMergeable = false;
 				mState.mCursorPosition = mInteractiveEnd = ScreenPosToCoordinates(ImGui::GetMousePos());
 				SetSelection(mInteractiveStart, mInteractiveEnd, mSelectionMode);
 			}
@@ -856,16 +1060,28 @@ void TextEditor::HandleMouseInputs()
 
 void TextEditor::Render()
 {
-	/* Compute mCharAdvance regarding to scaled font size (Ctrl + mouse wheel)*/
-	const float fontSize = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, "#", nullptr, nullptr).x;
-	mCharAdvance = ImVec2(fontSize, ImGui::GetTextLineHeightWithSpacing() * mLineSpacing);
+	/* Compute mCharAdvance regarding to scaled font size (Ctrl + mouse wheel), when the font changes */
+	if (ImGui::GetFont() != mFont || ImGui::GetFontSize() != mFontSize)
+	{
+		mFont = ImGui::GetFont();
+		mFontSize = ImGui::GetFontSize();
+		const float fontSize = mFont->CalcTextSizeA(mFontSize, FLT_MAX, -1.0f, "#", nullptr, nullptr).x;
+		mCharAdvance = ImVec2(fontSize, ImGui::GetTextLineHeightWithSpacing() * mLineSpacing);
+		mSpaceSize = mFont->CalcTextSizeA(mFontSize, FLT_MAX, -1.0f, " ", nullptr, nullptr).x;
+		mTextStartLines = -1;
+		std::fill(mLineWidths.begin(), mLineWidths.end(), -1.0f);
+	}
 
-	/* Update palette with the current alpha from style */
-	for (int i = 0; i < (int)PaletteIndex::Max; ++i)
+	/* Update palette with the current alpha from style, when it changes */
+	if (ImGui::GetStyle().Alpha != mPaletteAlpha)
 	{
-		auto color = ImGui::ColorConvertU32ToFloat4(mPaletteBase[i]);
-		color.w *= ImGui::GetStyle().Alpha;
-		mPalette[i] = ImGui::ColorConvertFloat4ToU32(color);
+		mPaletteAlpha = ImGui::GetStyle().Alpha;
+		for (int i = 0; i < (int)PaletteIndex::Max; ++i)
+		{
+			auto color = ImGui::ColorConvertU32ToFloat4(mPaletteBase[i]);
+			color.w *= mPaletteAlpha;
+			mPalette[i] = ImGui::ColorConvertFloat4ToU32(color);
+		}
 	}
 
 	assert(mLineBuffer.empty());
@@ -887,15 +1103,21 @@ void TextEditor::Render()
 	auto lineNo = (int)floor(scrollY / mCharAdvance.y);
 	auto globalLineMax = (int)mLines.size();
 	auto lineMax = std::max(0, std::min((int)mLines.size() - 1, lineNo + (int)floor((scrollY + contentSize.y) / mCharAdvance.y)));
+	mFirstVisibleLine = lineNo;
+	mLastVisibleLine = lineMax;
 
 	// Deduce mTextStart by evaluating mLines size (global lineMax) plus two spaces as text width
 	char buf[16];
-	snprintf(buf, 16, " %d ", globalLineMax);
-	mTextStart = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, buf, nullptr, nullptr).x + mLeftMargin;
+	if (globalLineMax != mTextStartLines)
+	{
+		mTextStartLines = globalLineMax;
+		snprintf(buf, 16, " %d ", globalLineMax);
+		mTextStart = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, buf, nullptr, nullptr).x + mLeftMargin;
+	}
 
 	if (!mLines.empty())
 	{
-		float spaceSize = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, " ", nullptr, nullptr).x;
+		const float spaceSize = mSpaceSize;
 
 		while (lineNo <= lineMax)
 		{
@@ -903,7 +1125,7 @@ void TextEditor::Render()
 			ImVec2 textScreenPos = ImVec2(lineStartScreenPos.x + mTextStart, lineStartScreenPos.y);
 
 			auto& line = mLines[lineNo];
-			longest = std::max(mTextStart + TextDistanceToLineStart(Coordinates(lineNo, GetLineMaxColumn(lineNo))), longest);
+			longest = std::max(mTextStart + GetLineWidth(lineNo), longest);
 			auto columnNo = 0;
 			Coordinates lineStartCoord(lineNo, 0);
 			Coordinates lineEndCoord(lineNo, GetLineMaxColumn(lineNo));
@@ -1012,21 +1234,26 @@ void TextEditor::Render()
 				}
 			}
 
-			// Render colorized text
+			// Render colorized text: one call per run of glyphs of the same colour, broken by tabs only.
+			// Spaces take the colour of the run they are in.
 			auto prevColor = line.empty() ? mPalette[(int)PaletteIndex::Default] : GetGlyphColor(line[0]);
 			ImVec2 bufferOffset;
+			float runWidth = 0.0f;     // of mLineBuffer up to runMeasured
+			size_t runMeasured = 0;
 
 			for (int i = 0; i < line.size();)
 			{
 				auto& glyph = line[i];
-				auto color = GetGlyphColor(glyph);
+				auto color = glyph.mChar == ' ' ? prevColor : GetGlyphColor(glyph);
 
-				if ((color != prevColor || glyph.mChar == '\t' || glyph.mChar == ' ') && !mLineBuffer.empty())
+				if ((color != prevColor || glyph.mChar == '\t') && !mLineBuffer.empty())
 				{
 					const ImVec2 newOffset(textScreenPos.x + bufferOffset.x, textScreenPos.y + bufferOffset.y);
 					drawList->AddText(newOffset, prevColor, mLineBuffer.c_str());
-					auto textSize = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, mLineBuffer.c_str(), nullptr, nullptr);
-					bufferOffset.x += textSize.x;
+					auto textSize = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, mLineBuffer.c_str() + runMeasured, nullptr, nullptr);
+					bufferOffset.x += runWidth + textSize.x;
+					runWidth = 0.0f;
+					runMeasured = 0;
 					mLineBuffer.clear();
 				}
 				prevColor = color;
@@ -1056,18 +1283,22 @@ void TextEditor::Render()
 				{
 					if (mShowWhitespaces)
 					{
+						// position of the space within the run
+						runWidth += ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, mLineBuffer.c_str() + runMeasured, nullptr, nullptr).x;
+						runMeasured = mLineBuffer.size() + 1;
 						const auto s = ImGui::GetFontSize();
-						const auto x = textScreenPos.x + bufferOffset.x + spaceSize * 0.5f;
+						const auto x = textScreenPos.x + bufferOffset.x + runWidth + spaceSize * 0.5f;
 						const auto y = textScreenPos.y + bufferOffset.y + s * 0.5f;
 						drawList->AddCircleFilled(ImVec2(x, y), 1.5f, 0x80808080, 4);
+						runWidth += spaceSize;
 					}
-					bufferOffset.x += spaceSize;
+					mLineBuffer.push_back(' ');
 					i++;
 				}
 				else
 				{
 					auto l = UTF8CharLength(glyph.mChar);
-					while (l-- > 0)
+					while (l-- > 0 && i < line.size())
 						mLineBuffer.push_back(line[i++].mChar);
 				}
 				++columnNo;
@@ -1089,8 +1320,8 @@ void TextEditor::Render()
 			auto id = GetWordAt(ScreenPosToCoordinates(ImGui::GetMousePos()));
 			if (!id.empty())
 			{
-				auto it = mLanguageDefinition.mIdentifiers.find(id);
-				if (it != mLanguageDefinition.mIdentifiers.end())
+				auto it = mLanguage->mDefinition.mIdentifiers.find(id);
+				if (it != mLanguage->mDefinition.mIdentifiers.end())
 				{
 					ImGui::BeginTooltip();
 					ImGui::TextUnformatted(it->second.mDeclaration.c_str());
@@ -1098,8 +1329,8 @@ void TextEditor::Render()
 				}
 				else
 				{
-					auto pi = mLanguageDefinition.mPreprocIdentifiers.find(id);
-					if (pi != mLanguageDefinition.mPreprocIdentifiers.end())
+					auto pi = mLanguage->mDefinition.mPreprocIdentifiers.find(id);
+					if (pi != mLanguage->mDefinition.mPreprocIdentifiers.end())
 					{
 						ImGui::BeginTooltip();
 						ImGui::TextUnformatted(pi->second.mDeclaration.c_str());
@@ -1158,27 +1389,112 @@ void TextEditor::Render(const char* aTitle, const ImVec2& aSize, bool aBorder)
 
 void TextEditor::SetText(const std::string & aText)
 {
-	mLines.clear();
-	mLines.emplace_back(Line());
-	for (auto chr : aText)
+	SetText(aText.data(), aText.size());
+}
+
+void TextEditor::SetText(const char* aText, size_t aSize)
+{
+	// large texts are split by several threads, each one on its own chunk of bytes
+	static const size_t ParallelChunkSize = 1 << 20;
+	const size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+	const size_t chunkCount = std::max<size_t>(1, std::min(hardwareThreads, aSize / ParallelChunkSize));
+	const size_t chunkSize = (aSize + chunkCount - 1) / std::max<size_t>(1, chunkCount);
+
+	struct Chunk
+	{
+		size_t mBegin, mEnd;
+		std::vector<size_t> mLineEnds;	// offsets of the '\n' of the chunk
+		size_t mFirstLine, mFirstLineStart;
+		size_t mGlyphCount, mCharCount;
+	};
+	std::vector<Chunk> chunks(chunkCount);
+	for (size_t i = 0; i < chunkCount; ++i)
 	{
-		if (chr == '\r')
+		chunks[i].mBegin = std::min(aSize, i * chunkSize);
+		chunks[i].mEnd = std::min(aSize, (i + 1) * chunkSize);
+	}
+
+	auto forEachChunk = [&chunks](auto aWork)
+	{
+		std::vector<std::thread> workers;
+		workers.reserve(chunks.size() - 1);
+		for (size_t i = 1; i < chunks.size(); ++i)
+			workers.emplace_back(aWork, std::ref(chunks[i]));
+		aWork(chunks[0]);
+		for (auto& worker : workers)
+			worker.join();
+	};
+
+	// memchr is vectorized by the C library
+	forEachChunk([aText](Chunk& aChunk)
+	{
+		for (auto it = aText + aChunk.mBegin, end = aText + aChunk.mEnd; it < end; ++it)
 		{
-			// ignore the carriage return character
+			it = static_cast<const char*>(std::memchr(it, '\n', end - it));
+			if (it == nullptr)
+				break;
+			aChunk.mLineEnds.push_back(it - aText);
 		}
-		else if (chr == '\n')
-			mLines.emplace_back(Line());
-		else
+	});
+
+	// a chunk owns the lines ending in it, the last one also owns the last line of the text
+	size_t lineCount = 0;
+	size_t lineStart = 0;
+	for (auto& chunk : chunks)
+	{
+		chunk.mFirstLine = lineCount;
+		chunk.mFirstLineStart = lineStart;
+		lineCount += chunk.mLineEnds.size();
+		if (!chunk.mLineEnds.empty())
+			lineStart = chunk.mLineEnds.back() + 1;
+	}
+	chunks.back().mLineEnds.push_back(aSize);
+	++lineCount;
+
+	// every line is allocated once, to its size
+	mLines.clear();
+	mLines.resize(lineCount);
+	forEachChunk([this, aText](Chunk& aChunk)
+	{
+		aChunk.mGlyphCount = 0;
+		aChunk.mCharCount = 0;
+		auto start = aChunk.mFirstLineStart;
+		auto line = mLines.begin() + aChunk.mFirstLine;
+		for (const auto end : aChunk.mLineEnds)
 		{
-			mLines.back().emplace_back(Glyph(chr, PaletteIndex::Default));
+			line->reserve(end - start);
+			for (auto i = start; i < end; ++i)
+			{
+				// ignore the carriage return character
+				const auto c = aText[i];
+				if (c != '\r')
+				{
+					line->emplace_back(Glyph(c, PaletteIndex::Default));
+					aChunk.mCharCount += (c & 0xC0) != 0x80 ? 1 : 0;
+				}
+			}
+			aChunk.mGlyphCount += line->size();
+			start = end + 1;
+			++line;
 		}
+	});
+
+	mGlyphCount = 0;
+	mCharCount = 0;
+	for (const auto& chunk : chunks)
+	{
+		mGlyphCount += chunk.mGlyphCount;
+		mCharCount += chunk.mCharCount;
 	}
+	++mTextGeneration;
 
 	mTextChanged = true;
 	mScrollToTop = true;
 
 	mUndoBuffer.clear();
 	mUndoIndex = 0;
+	mUndoMemory = 0;
+	mUndoMergeable = false;
 
 	Colorize();
 }
@@ -1204,12 +1520,15 @@ void TextEditor::SetTextLines(const std::vector<std::string> & aLines)
 				mLines[i].emplace_back(Glyph(aLine[j], PaletteIndex::Default));
 		}
 	}
+	RecountText();
 
 	mTextChanged = true;
 	mScrollToTop = true;
 
 	mUndoBuffer.clear();
 	mUndoIndex = 0;
+	mUndoMemory = 0;
+	mUndoMergeable = false;
 
 	Colorize();
 }
@@ -1259,6 +1578,7 @@ void TextEditor::EnterCharacter(ImWchar aChar, bool aShift)
 					{
 						if (line.front().mChar == '\t')
 						{
+							CountGlyph(line.front().mChar, -1);
 							line.erase(line.begin());
 							modified = true;
 						}
@@ -1266,6 +1586,7 @@ void TextEditor::EnterCharacter(ImWchar aChar, bool aShift)
 						{
 							for (int j = 0; j < mTabSize && !line.empty() && line.front().mChar == ' '; j++)
 							{
+								CountGlyph(line.front().mChar, -1);
 								line.erase(line.begin());
 								modified = true;
 							}
@@ -1274,6 +1595,7 @@ void TextEditor::EnterCharacter(ImWchar aChar, bool aShift)
 				}
 				else
 				{
+					CountGlyph('\t', 1);
 					line.insert(line.begin(), Glyph('\t', TextEditor::PaletteIndex::Background));
 					modified = true;
 				}
@@ -1305,6 +1627,7 @@ void TextEditor::EnterCharacter(ImWchar aChar, bool aShift)
 				AddUndo(u);
 
 				mTextChanged = true;
+				Colorize(start.mLine, end.mLine - start.mLine + 1);
 
 				EnsureCursorVisible();
 			}
@@ -1331,10 +1654,14 @@ void TextEditor::EnterCharacter(ImWchar aChar, bool aShift)
 		auto& line = mLines[coord.mLine];
 		auto& newLine = mLines[coord.mLine + 1];
 
-		if (mLanguageDefinition.mAutoIndentation)
+		if (mLanguage->mDefinition.mAutoIndentation)
 			for (size_t it = 0; it < line.size() && isascii(line[it].mChar) && isblank(line[it].mChar); ++it)
+			{
+				CountGlyph(line[it].mChar, 1);
 				newLine.push_back(line[it]);
+			}
 
+		// the end of the line is moved to the new line: the counts do not change
 		const size_t whitespaceSize = newLine.size();
 		auto cindex = GetCharacterIndex(coord);
 		newLine.insert(newLine.end(), line.begin() + cindex, line.end());
@@ -1362,12 +1689,16 @@ void TextEditor::EnterCharacter(ImWchar aChar, bool aShift)
 				while (d-- > 0 && cindex < (int)line.size())
 				{
 					u.mRemoved += line[cindex].mChar;
+					CountGlyph(line[cindex].mChar, -1);
 					line.erase(line.begin() + cindex);
 				}
 			}
 
 			for (auto p = buf; *p != '\0'; p++, ++cindex)
+			{
+				CountGlyph(*p, 1);
 				line.insert(line.begin() + cindex, Glyph(*p, PaletteIndex::Default));
+			}
 			u.mAdded = buf;
 
 			SetCursorPosition(Coordinates(coord.mLine, GetCharacterColumn(coord.mLine, cindex)));
@@ -1462,6 +1793,7 @@ void TextEditor::SetSelection(const Coordinates & aStart, const Coordinates & aE
 void TextEditor::SetTabSize(int aValue)
 {
 	mTabSize = std::max(0, std::min(32, aValue));
+	std::fill(mLineWidths.begin(), mLineWidths.end(), -1.0f);
 }
 
 void TextEditor::InsertText(const std::string & aValue)
@@ -1501,6 +1833,7 @@ void TextEditor::DeleteSelection()
 
 void TextEditor::MoveUp(int aAmount, bool aSelect)
 {
+	mUndoMergeable = false;
 	auto oldPos = mState.mCursorPosition;
 	mState.mCursorPosition.mLine = std::max(0, mState.mCursorPosition.mLine - aAmount);
 	if (oldPos != mState.mCursorPosition)
@@ -1527,6 +1860,7 @@ void TextEditor::MoveUp(int aAmount, bool aSelect)
 
 void TextEditor::MoveDown(int aAmount, bool aSelect)
 {
+	mUndoMergeable = false;
 	assert(mState.mCursorPosition.mColumn >= 0);
 	auto oldPos = mState.mCursorPosition;
 	mState.mCursorPosition.mLine = std::max(0, std::min((int)mLines.size() - 1, mState.mCursorPosition.mLine + aAmount));
@@ -1553,13 +1887,9 @@ void TextEditor::MoveDown(int aAmount, bool aSelect)
 	}
 }
 
-static bool IsUTFSequence(char c)
-{
-	return (c & 0xC0) == 0x80;
-}
-
 void TextEditor::MoveLeft(int aAmount, bool aSelect, bool aWordMode)
 {
+	mUndoMergeable = false;
 	if (mLines.empty())
 		return;
 
@@ -1626,6 +1956,7 @@ void TextEditor::MoveLeft(int aAmount, bool aSelect, bool aWordMode)
 
 void TextEditor::MoveRight(int aAmount, bool aSelect, bool aWordMode)
 {
+	mUndoMergeable = false;
 	auto oldPos = mState.mCursorPosition;
 
 	if (mLines.empty() || oldPos.mLine >= mLines.size())
@@ -1677,6 +2008,7 @@ void TextEditor::MoveRight(int aAmount, bool aSelect, bool aWordMode)
 
 void TextEditor::MoveTop(bool aSelect)
 {
+	mUndoMergeable = false;
 	auto oldPos = mState.mCursorPosition;
 	SetCursorPosition(Coordinates(0, 0));
 
@@ -1695,6 +2027,7 @@ void TextEditor::MoveTop(bool aSelect)
 
 void TextEditor::TextEditor::MoveBottom(bool aSelect)
 {
+	mUndoMergeable = false;
 	auto oldPos = GetCursorPosition();
 	auto newPos = Coordinates((int)mLines.size() - 1, 0);
 	SetCursorPosition(newPos);
@@ -1710,6 +2043,7 @@ void TextEditor::TextEditor::MoveBottom(bool aSelect)
 
 void TextEditor::MoveHome(bool aSelect)
 {
+	mUndoMergeable = false;
 	auto oldPos = mState.mCursorPosition;
 	SetCursorPosition(Coordinates(mState.mCursorPosition.mLine, 0));
 
@@ -1735,6 +2069,7 @@ void TextEditor::MoveHome(bool aSelect)
 
 void TextEditor::MoveEnd(bool aSelect)
 {
+	mUndoMergeable = false;
 	auto oldPos = mState.mCursorPosition;
 	SetCursorPosition(Coordinates(mState.mCursorPosition.mLine, GetLineMaxColumn(oldPos.mLine)));
 
@@ -1792,6 +2127,7 @@ void TextEditor::Delete()
 			Advance(u.mRemovedEnd);
 
 			auto& nextLine = mLines[pos.mLine + 1];
+			CountGlyphs(nextLine, 0, (int)nextLine.size(), 1); // copied, the next line being removed
 			line.insert(line.end(), nextLine.begin(), nextLine.end());
 			RemoveLine(pos.mLine + 1);
 		}
@@ -1804,7 +2140,10 @@ void TextEditor::Delete()
 
 			auto d = UTF8CharLength(line[cindex].mChar);
 			while (d-- > 0 && cindex < (int)line.size())
+			{
+				CountGlyph(line[cindex].mChar, -1);
 				line.erase(line.begin() + cindex);
+			}
 		}
 
 		mTextChanged = true;
@@ -1851,6 +2190,7 @@ void TextEditor::Backspace()
 			auto& line = mLines[mState.mCursorPosition.mLine];
 			auto& prevLine = mLines[mState.mCursorPosition.mLine - 1];
 			auto prevSize = GetLineMaxColumn(mState.mCursorPosition.mLine - 1);
+			CountGlyphs(line, 0, (int)line.size(), 1); // copied, the line being removed
 			prevLine.insert(prevLine.end(), line.begin(), line.end());
 
 			ErrorMarkers etmp;
@@ -1880,6 +2220,7 @@ void TextEditor::Backspace()
 			while (cindex < line.size() && cend-- > cindex)
 			{
 				u.mRemoved += line[cindex].mChar;
+				CountGlyph(line[cindex].mChar, -1);
 				line.erase(line.begin() + cindex);
 			}
 		}
@@ -1896,12 +2237,14 @@ void TextEditor::Backspace()
 
 void TextEditor::SelectWordUnderCursor()
 {
+	mUndoMergeable = false;
 	auto c = GetCursorPosition();
 	SetSelection(FindWordStart(c), FindWordEnd(c));
 }
 
 void TextEditor::SelectAll()
 {
+	mUndoMergeable = false;
 	SetSelection(Coordinates(0, 0), Coordinates((int)mLines.size(), 0));
 }
 
@@ -1996,12 +2339,14 @@ bool TextEditor::CanRedo() const
 
 void TextEditor::Undo(int aSteps)
 {
+	mUndoMergeable = false;
 	while (CanUndo() && aSteps-- > 0)
 		mUndoBuffer[--mUndoIndex].Undo(this);
 }
 
 void TextEditor::Redo(int aSteps)
 {
+	mUndoMergeable = false;
 	while (CanRedo() && aSteps-- > 0)
 		mUndoBuffer[mUndoIndex++].Redo(this);
 }
@@ -2136,12 +2481,178 @@ void TextEditor::ProcessInputs()
 
 void TextEditor::Colorize(int aFromLine, int aLines)
 {
+	SyncLineStates();
+
+	aFromLine = std::max(0, aFromLine);
 	int toLine = aLines == -1 ? (int)mLines.size() : std::min((int)mLines.size(), aFromLine + aLines);
-	mColorRangeMin = std::min(mColorRangeMin, aFromLine);
-	mColorRangeMax = std::max(mColorRangeMax, toLine);
-	mColorRangeMin = std::max(0, mColorRangeMin);
-	mColorRangeMax = std::max(mColorRangeMin, mColorRangeMax);
-	mCheckComments = true;
+	for (int i = aFromLine; i < toLine; ++i)
+	{
+		mLineColorized[i] = false;
+		mLineWidths[i] = -1.0f;
+	}
+
+	mColorizeFrom = std::min(mColorizeFrom, aFromLine);
+	mScanFrom = std::min(mScanFrom, aFromLine);
+	mScanTo = std::max(mScanTo, toLine);
+}
+
+void TextEditor::SyncLineStates()
+{
+	// Lines are inserted and removed in step with mLines; only a text replaced as a whole gets here out of sync
+	if (mLineStates.size() == mLines.size() + 1)
+		return;
+
+	mLineStates.assign(mLines.size() + 1, LineState());
+	mLineColorized.assign(mLines.size(), false);
+	mLineWidths.assign(mLines.size(), -1.0f);
+	mScanFrom = 0;
+	mScanTo = (int)mLines.size();
+	mColorizeFrom = 0;
+}
+
+void TextEditor::ColorizeLine(int aLine)
+{
+	ColorizeRange(aLine, aLine + 1);
+	mLineColorized[aLine] = true;
+}
+
+void TextEditor::ColorizeAll()
+{
+	if (mLines.empty() || !mColorizerEnabled)
+		return;
+
+	Colorize();
+	for (int i = 0; i < (int)mLines.size(); ++i)
+		mLineStates[i + 1] = ScanLine(i, mLineStates[i]);
+	ColorizeRange(0, (int)mLines.size());
+
+	mLineColorized.assign(mLines.size(), true);
+	mScanFrom = std::numeric_limits<int>::max();
+	mScanTo = 0;
+	mColorizeFrom = std::numeric_limits<int>::max();
+}
+
+void TextEditor::ColorizeInBackground()
+{
+	ColorizeInternal();
+}
+
+void TextEditor::WordTable::Build(const LanguageDefinition& aLanguageDef)
+{
+	mCaseSensitive = aLanguageDef.mCaseSensitive;
+
+	// a word belonging to several sets gets all their kinds
+	std::unordered_map<std::string, uint8_t> kinds;
+	auto add = [&](const std::string& aWord, Kind aKind)
+	{
+		// tokens of a case insensitive language are looked up in upper case: a word with lower case letters never matched
+		if (aWord.empty() || (!mCaseSensitive && std::any_of(aWord.begin(), aWord.end(), [](char c) { return islower((unsigned char)c) != 0; })))
+			return;
+		kinds[aWord] |= aKind;
+	};
+	for (auto& k : aLanguageDef.mKeywords)
+		add(k, Keyword);
+	for (auto& i : aLanguageDef.mIdentifiers)
+		add(i.first, KnownIdentifier);
+	for (auto& i : aLanguageDef.mPreprocIdentifiers)
+		add(i.first, PreprocIdentifier);
+
+	std::vector<Entry> words;
+	words.reserve(kinds.size());
+	for (auto& k : kinds)
+		words.push_back(Entry{ k.first, k.second });
+
+	uint32_t nbSlots = 1;
+	while (nbSlots < 2 * words.size())
+		nbSlots <<= 1;
+	// only two words with the same 32 bits hash can make it fail for good: they are then left out
+	while (!Place(words, nbSlots) && nbSlots < (1u << 16))
+		nbSlots <<= 1;
+}
+
+bool TextEditor::WordTable::Place(const std::vector<Entry>& aWords, uint32_t aNbSlots)
+{
+	// Hash and displace: the words are spread in buckets, then each bucket looks for the seed
+	// sending all of its words to free slots, the fullest buckets first
+	const uint32_t nbBuckets = std::max(1u, aNbSlots / 4);
+	std::vector<std::vector<std::pair<uint32_t, const Entry*>>> buckets(nbBuckets);
+	for (auto& w : aWords)
+	{
+		const auto hash = Hash(w.mWord.data(), w.mWord.data() + w.mWord.size());
+		buckets[hash & (nbBuckets - 1)].push_back(std::make_pair(hash, &w));
+	}
+	std::vector<uint32_t> order(nbBuckets);
+	std::iota(order.begin(), order.end(), 0u);
+	std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return buckets[a].size() > buckets[b].size(); });
+
+	mSeeds.assign(nbBuckets, 0u);
+	mSlots.assign(aNbSlots, Entry());
+
+	bool placed = true;
+	std::vector<uint32_t> slots;
+	for (auto b : order)
+	{
+		auto& bucket = buckets[b];
+		if (bucket.empty())
+			break;
+
+		bool found = false;
+		for (uint32_t seed = 1; seed < 0x10000 && !found; ++seed)
+		{
+			found = true;
+			slots.clear();
+			for (auto& w : bucket)
+			{
+				const auto slot = Slot(w.first, seed) & (aNbSlots - 1);
+				if (!mSlots[slot].mWord.empty() || std::find(slots.begin(), slots.end(), slot) != slots.end())
+				{
+					found = false;
+					break;
+				}
+				slots.push_back(slot);
+			}
+			if (found)
+			{
+				mSeeds[b] = seed;
+				for (size_t i = 0; i < bucket.size(); ++i)
+					mSlots[slots[i]] = *bucket[i].second;
+			}
+		}
+		placed = placed && found;
+	}
+	return placed;
+}
+
+uint32_t TextEditor::WordTable::Hash(const char* aBegin, const char* aEnd) const
+{
+	// FNV-1a
+	uint32_t hash = 2166136261u;
+	for (auto p = aBegin; p != aEnd; ++p)
+	{
+		const auto c = mCaseSensitive ? (uint8_t)*p : (uint8_t)toupper((unsigned char)*p);
+		hash = (hash ^ c) * 16777619u;
+	}
+	return hash;
+}
+
+uint8_t TextEditor::WordTable::Find(const char* aBegin, const char* aEnd) const
+{
+	if (mSlots.empty())
+		return None;
+
+	const auto hash = Hash(aBegin, aEnd);
+	const auto& entry = mSlots[Slot(hash, mSeeds[hash & (mSeeds.size() - 1)]) & (mSlots.size() - 1)];
+
+	// the slot holds the only word which could match
+	if (entry.mWord.size() != size_t(aEnd - aBegin))
+		return None;
+	for (size_t i = 0; i < entry.mWord.size(); ++i)
+	{
+		const auto c = mCaseSensitive ? aBegin[i] : (char)toupper((unsigned char)aBegin[i]);
+		if (c != entry.mWord[i])
+			return None;
+	}
+	return entry.mKinds;
 }
 
 void TextEditor::ColorizeRange(int aFromLine, int aToLine)
@@ -2151,7 +2662,6 @@ void TextEditor::ColorizeRange(int aFromLine, int aToLine)
 
 	std::string buffer;
 	std::cmatch results;
-	std::string id;
 
 	int endLine = std::max(0, std::min((int)mLines.size(), aToLine));
 	for (int i = aFromLine; i < endLine; ++i)
@@ -2182,9 +2692,9 @@ void TextEditor::ColorizeRange(int aFromLine, int aToLine)
 
 			bool hasTokenizeResult = false;
 
-			if (mLanguageDefinition.mTokenize != nullptr)
+			if (mLanguage->mDefinition.mTokenize != nullptr)
 			{
-				if (mLanguageDefinition.mTokenize(first, last, token_begin, token_end, token_color))
+				if (mLanguage->mDefinition.mTokenize(first, last, token_begin, token_end, token_color))
 					hasTokenizeResult = true;
 			}
 
@@ -2193,7 +2703,7 @@ void TextEditor::ColorizeRange(int aFromLine, int aToLine)
 				// todo : remove
 				//printf("using regex for %.*s\n", first + 10 < last ? 10 : int(last - first), first);
 
-				for (auto& p : mRegexList)
+				for (auto& p : mLanguage->mRegexList)
 				{
 					if (std::regex_search(first, last, results, p.first, std::regex_constants::match_continuous))
 					{
@@ -2218,24 +2728,20 @@ void TextEditor::ColorizeRange(int aFromLine, int aToLine)
 
 				if (token_color == PaletteIndex::Identifier)
 				{
-					id.assign(token_begin, token_end);
-
-					// todo : allmost all language definitions use lower case to specify keywords, so shouldn't this use ::tolower ?
-					if (!mLanguageDefinition.mCaseSensitive)
-						std::transform(id.begin(), id.end(), id.begin(), ::toupper);
+					const auto kinds = mLanguage->mWordTable.Find(token_begin, token_end);
 
 					if (!line[first - bufferBegin].mPreprocessor)
 					{
-						if (mLanguageDefinition.mKeywords.count(id) != 0)
+						if (kinds & WordTable::Keyword)
 							token_color = PaletteIndex::Keyword;
-						else if (mLanguageDefinition.mIdentifiers.count(id) != 0)
+						else if (kinds & WordTable::KnownIdentifier)
 							token_color = PaletteIndex::KnownIdentifier;
-						else if (mLanguageDefinition.mPreprocIdentifiers.count(id) != 0)
+						else if (kinds & WordTable::PreprocIdentifier)
 							token_color = PaletteIndex::PreprocIdentifier;
 					}
 					else
 					{
-						if (mLanguageDefinition.mPreprocIdentifiers.count(id) != 0)
+						if (kinds & WordTable::PreprocIdentifier)
 							token_color = PaletteIndex::PreprocIdentifier;
 					}
 				}
@@ -2249,147 +2755,165 @@ void TextEditor::ColorizeRange(int aFromLine, int aToLine)
 	}
 }
 
-void TextEditor::ColorizeInternal()
+TextEditor::LineState TextEditor::ScanLine(int aLine, LineState aState)
 {
-	if (mLines.empty() || !mColorizerEnabled)
-		return;
+	auto& line = mLines[aLine];
 
-	if (mCheckComments)
+	if (!aState.mConcatenate)
 	{
-		auto endLine = mLines.size();
-		auto endIndex = 0;
-		auto commentStartLine = endLine;
-		auto commentStartIndex = endIndex;
-		auto withinString = false;
-		auto withinSingleLineComment = false;
-		auto withinPreproc = false;
-		auto firstChar = true;			// there is no other non-whitespace characters in the line before
-		auto concatenate = false;		// '\' on the very end of the line
-		auto currentLine = 0;
-		auto currentIndex = 0;
-		while (currentLine < endLine || currentIndex < endIndex)
-		{
-			auto& line = mLines[currentLine];
+		aState.mWithinSingleLineComment = false;
+		aState.mWithinPreproc = false;
+		aState.mFirstChar = true;
+	}
+	aState.mConcatenate = false;
 
-			if (currentIndex == 0 && !concatenate)
-			{
-				withinSingleLineComment = false;
-				withinPreproc = false;
-				firstChar = true;
-			}
+	auto pred = [](const char& a, const Glyph& b) { return a == b.mChar; };
+	auto& startStr = mLanguage->mDefinition.mCommentStart;
+	auto& endStr = mLanguage->mDefinition.mCommentEnd;
+	auto& singleStartStr = mLanguage->mDefinition.mSingleLineComment;
 
-			concatenate = false;
+	int currentIndex = 0;
+	while (currentIndex < (int)line.size())
+	{
+		auto c = line[currentIndex].mChar;
 
-			if (!line.empty())
-			{
-				auto& g = line[currentIndex];
-				auto c = g.mChar;
+		aState.mConcatenate = false;
 
-				if (c != mLanguageDefinition.mPreprocChar && !isspace(c))
-					firstChar = false;
+		if (c != mLanguage->mDefinition.mPreprocChar && !isspace(c))
+			aState.mFirstChar = false;
 
-				if (currentIndex == (int)line.size() - 1 && line[line.size() - 1].mChar == '\\')
-					concatenate = true;
+		if (currentIndex == (int)line.size() - 1 && c == '\\')
+			aState.mConcatenate = true;
 
-				bool inComment = (commentStartLine < currentLine || (commentStartLine == currentLine && commentStartIndex <= currentIndex));
+		if (aState.mWithinString)
+		{
+			line[currentIndex].mMultiLineComment = aState.mInComment;
 
-				if (withinString)
+			if (c == '\"')
+			{
+				if (currentIndex + 1 < (int)line.size() && line[currentIndex + 1].mChar == '\"')
 				{
-					line[currentIndex].mMultiLineComment = inComment;
-
-					if (c == '\"')
-					{
-						if (currentIndex + 1 < (int)line.size() && line[currentIndex + 1].mChar == '\"')
-						{
-							currentIndex += 1;
-							if (currentIndex < (int)line.size())
-								line[currentIndex].mMultiLineComment = inComment;
-						}
-						else
-							withinString = false;
-					}
-					else if (c == '\\')
-					{
-						currentIndex += 1;
-						if (currentIndex < (int)line.size())
-							line[currentIndex].mMultiLineComment = inComment;
-					}
+					currentIndex += 1;
+					if (currentIndex < (int)line.size())
+						line[currentIndex].mMultiLineComment = aState.mInComment;
 				}
 				else
-				{
-					if (firstChar && c == mLanguageDefinition.mPreprocChar)
-						withinPreproc = true;
+					aState.mWithinString = false;
+			}
+			else if (c == '\\')
+			{
+				currentIndex += 1;
+				if (currentIndex < (int)line.size())
+					line[currentIndex].mMultiLineComment = aState.mInComment;
+			}
+		}
+		else
+		{
+			if (aState.mFirstChar && c == mLanguage->mDefinition.mPreprocChar)
+				aState.mWithinPreproc = true;
 
-					if (c == '\"')
-					{
-						withinString = true;
-						line[currentIndex].mMultiLineComment = inComment;
-					}
-					else
-					{
-						auto pred = [](const char& a, const Glyph& b) { return a == b.mChar; };
-						auto from = line.begin() + currentIndex;
-						auto& startStr = mLanguageDefinition.mCommentStart;
-						auto& singleStartStr = mLanguageDefinition.mSingleLineComment;
-
-						if (singleStartStr.size() > 0 &&
-							currentIndex + singleStartStr.size() <= line.size() &&
-							equals(singleStartStr.begin(), singleStartStr.end(), from, from + singleStartStr.size(), pred))
-						{
-							withinSingleLineComment = true;
-						}
-						else if (!withinSingleLineComment && currentIndex + startStr.size() <= line.size() &&
-							equals(startStr.begin(), startStr.end(), from, from + startStr.size(), pred))
-						{
-							commentStartLine = currentLine;
-							commentStartIndex = currentIndex;
-						}
+			if (c == '\"')
+			{
+				aState.mWithinString = true;
+				line[currentIndex].mMultiLineComment = aState.mInComment;
+			}
+			else
+			{
+				auto from = line.begin() + currentIndex;
 
-						inComment = inComment = (commentStartLine < currentLine || (commentStartLine == currentLine && commentStartIndex <= currentIndex));
+				if (singleStartStr.size() > 0 &&
+					currentIndex + singleStartStr.size() <= line.size() &&
+					equals(singleStartStr.begin(), singleStartStr.end(), from, from + singleStartStr.size(), pred))
+				{
+					aState.mWithinSingleLineComment = true;
+				}
+				else if (!aState.mWithinSingleLineComment && currentIndex + startStr.size() <= line.size() &&
+					equals(startStr.begin(), startStr.end(), from, from + startStr.size(), pred))
+				{
+					aState.mInComment = true;
+				}
 
-						line[currentIndex].mMultiLineComment = inComment;
-						line[currentIndex].mComment = withinSingleLineComment;
+				line[currentIndex].mMultiLineComment = aState.mInComment;
+				line[currentIndex].mComment = aState.mWithinSingleLineComment;
 
-						auto& endStr = mLanguageDefinition.mCommentEnd;
-						if (currentIndex + 1 >= (int)endStr.size() &&
-							equals(endStr.begin(), endStr.end(), from + 1 - endStr.size(), from + 1, pred))
-						{
-							commentStartIndex = endIndex;
-							commentStartLine = endLine;
-						}
-					}
-				}
-				line[currentIndex].mPreprocessor = withinPreproc;
-				currentIndex += UTF8CharLength(c);
-				if (currentIndex >= (int)line.size())
+				if (currentIndex + 1 >= (int)endStr.size() &&
+					equals(endStr.begin(), endStr.end(), from + 1 - endStr.size(), from + 1, pred))
 				{
-					currentIndex = 0;
-					++currentLine;
+					aState.mInComment = false;
 				}
 			}
-			else
-			{
-				currentIndex = 0;
-				++currentLine;
-			}
 		}
-		mCheckComments = false;
+		if (currentIndex < (int)line.size())
+			line[currentIndex].mPreprocessor = aState.mWithinPreproc;
+		currentIndex += UTF8CharLength(c);
 	}
 
-	if (mColorRangeMin < mColorRangeMax)
+	return aState;
+}
+
+void TextEditor::ColorizeInternal()
+{
+	if (mLines.empty() || !mColorizerEnabled)
+		return;
+
+	SyncLineStates();
+
+	// Whatever is left once the budget is spent carries over to the next frames, so a large file stays interactive
+	using Clock = std::chrono::steady_clock;
+	const auto deadline = Clock::now() + std::chrono::microseconds((long long)(mColorizeBudget * 1000.0f));
+	const int nbLines = (int)mLines.size();
+
+	// Comments, strings and preprocessor: rescan from the first modified line
+	// and stop as soon as the state at the start of a line is the one already known
+	bool scanned = true;
+	while (mScanFrom < nbLines)
 	{
-		const int increment = (mLanguageDefinition.mTokenize == nullptr) ? 10 : 10000;
-		const int to = std::min(mColorRangeMin + increment, mColorRangeMax);
-		ColorizeRange(mColorRangeMin, to);
-		mColorRangeMin = to;
+		const auto line = mScanFrom++;
+		const auto next = ScanLine(line, mLineStates[line]);
+		if (line >= mScanTo)
+		{
+			// an edit above changed how this line starts: its preprocessor tokens may differ
+			mLineColorized[line] = false;
+			mColorizeFrom = std::min(mColorizeFrom, line);
+		}
+		if (mScanFrom >= mScanTo && next == mLineStates[mScanFrom])
+			break;
+		mLineStates[mScanFrom] = next;
 
-		if (mColorRangeMax == mColorRangeMin)
+		if ((mScanFrom & 0xFF) == 0 && Clock::now() > deadline)
 		{
-			mColorRangeMin = std::numeric_limits<int>::max();
-			mColorRangeMax = 0;
+			scanned = false;
+			break;
 		}
-		return;
 	}
+	if (scanned)
+	{
+		mScanFrom = std::numeric_limits<int>::max();
+		mScanTo = 0;
+	}
+
+	// Tokens: the visible lines right away, the rest of the text in the background.
+	// Lines the scan has not reached yet are only colorized provisionally.
+	const int scanEnd = std::min(nbLines, mScanFrom);
+	const int lastVisible = std::min(mLastVisibleLine, nbLines - 1);
+	for (int i = std::max(0, mFirstVisibleLine); i <= lastVisible; ++i)
+	{
+		if (i >= scanEnd)
+			ColorizeRange(i, i + 1);
+		else if (!mLineColorized[i])
+			ColorizeLine(i);
+	}
+
+	while (mColorizeFrom < scanEnd && Clock::now() < deadline)
+	{
+		for (const int end = std::min(scanEnd, mColorizeFrom + 16); mColorizeFrom < end; ++mColorizeFrom)
+		{
+			if (!mLineColorized[mColorizeFrom])
+				ColorizeLine(mColorizeFrom);
+		}
+	}
+	if (mColorizeFrom >= nbLines)
+		mColorizeFrom = std::numeric_limits<int>::max();
 }
 
 float TextEditor::TextDistanceToLineStart(const Coordinates& aFrom) const
@@ -2398,29 +2922,43 @@ float TextEditor::TextDistanceToLineStart(const Coordinates& aFrom) const
 	float distance = 0.0f;
 	float spaceSize = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, " ", nullptr, nullptr).x;
 	int colIndex = GetCharacterIndex(aFrom);
+	std::string run; // the characters between two tabs are measured at once
 	for (size_t it = 0u; it < line.size() && it < colIndex; )
 	{
 		if (line[it].mChar == '\t')
 		{
+			if (!run.empty())
+			{
+				distance += ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, run.c_str(), nullptr, nullptr).x;
+				run.clear();
+			}
 			distance = (1.0f + std::floor((1.0f + distance) / (float(mTabSize) * spaceSize))) * (float(mTabSize) * spaceSize);
 			++it;
 		}
 		else
 		{
 			auto d = UTF8CharLength(line[it].mChar);
-			char tempCString[7];
-			int i = 0;
-			for (; i < 6 && d-- > 0 && it < (int)line.size(); i++, it++)
-				tempCString[i] = line[it].mChar;
-
-			tempCString[i] = '\0';
-			distance += ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, tempCString, nullptr, nullptr).x;
+			for (; d-- > 0 && it < line.size(); it++)
+				run.push_back(line[it].mChar);
 		}
 	}
+	if (!run.empty())
+		distance += ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, run.c_str(), nullptr, nullptr).x;
 
 	return distance;
 }
 
+float TextEditor::GetLineWidth(int aLine)
+{
+	if ((size_t)aLine >= mLineWidths.size())
+		return TextDistanceToLineStart(Coordinates(aLine, GetLineMaxColumn(aLine)));
+
+	// measured again once the line is modified, or the font or the tab size changed
+	if (mLineWidths[aLine] < 0.0f)
+		mLineWidths[aLine] = TextDistanceToLineStart(Coordinates(aLine, GetLineMaxColumn(aLine)));
+	return mLineWidths[aLine];
+}
+
 void TextEditor::EnsureCursorVisible()
 {
 	if (!mWithinRender)
@@ -2484,16 +3022,16 @@ TextEditor::UndoRecord::UndoRecord(
 
 void TextEditor::UndoRecord::Undo(TextEditor * aEditor)
 {
-	if (!mAdded.empty())
+	if (!GetAdded().empty())
 	{
 		aEditor->DeleteRange(mAddedStart, mAddedEnd);
 		aEditor->Colorize(mAddedStart.mLine - 1, mAddedEnd.mLine - mAddedStart.mLine + 2);
 	}
 
-	if (!mRemoved.empty())
+	if (!GetRemoved().empty())
 	{
 		auto start = mRemovedStart;
-		aEditor->InsertTextAt(start, mRemoved.c_str());
+		aEditor->InsertTextAt(start, GetRemoved().c_str());
 		aEditor->Colorize(mRemovedStart.mLine - 1, mRemovedEnd.mLine - mRemovedStart.mLine + 2);
 	}
 
@@ -2504,16 +3042,16 @@ void TextEditor::UndoRecord::Undo(TextEditor * aEditor)
 
 void TextEditor::UndoRecord::Redo(TextEditor * aEditor)
 {
-	if (!mRemoved.empty())
+	if (!GetRemoved().empty())
 	{
 		aEditor->DeleteRange(mRemovedStart, mRemovedEnd);
 		aEditor->Colorize(mRemovedStart.mLine - 1, mRemovedEnd.mLine - mRemovedStart.mLine + 1);
 	}
 
-	if (!mAdded.empty())
+	if (!GetAdded().empty())
 	{
 		auto start = mAddedStart;
-		aEditor->InsertTextAt(start, mAdded.c_str());
+		aEditor->InsertTextAt(start, GetAdded().c_str());
 		aEditor->Colorize(mAddedStart.mLine - 1, mAddedEnd.mLine - mAddedStart.mLine + 1);
 	}
 
@@ -2521,6 +3059,117 @@ void TextEditor::UndoRecord::Redo(TextEditor * aEditor)
 	aEditor->EnsureCursorVisible();
 }
 
+// Breaks the coalescing of keystrokes at the end of a word
+static bool IsWordEnd(char aLeft, char aRight)
+{
+	return !isspace((unsigned char)aLeft) && isspace((unsigned char)aRight);
+}
+
+bool TextEditor::UndoRecord::IsKeystroke() const
+{
+	// a single character, typed or erased
+	if (mAdded.empty() == mRemoved.empty() || mAddedShared || mRemovedShared)
+		return false;
+	const auto& text = mAdded.empty() ? mRemoved : mAdded;
+	return UTF8CharLength(text.front()) == (int)text.size();
+}
+
+bool TextEditor::UndoRecord::Merge(const UndoRecord& aNext)
+{
+	if (!aNext.IsKeystroke() || mAddedShared || mRemovedShared || aNext.mBefore.mCursorPosition != mAfter.mCursorPosition ||
+		aNext.mBefore.mSelectionStart != aNext.mBefore.mSelectionEnd)
+		return false;
+
+	// a character typed right after the text typed so far, on the same line
+	if (mRemoved.empty() && aNext.mRemoved.empty() && !mAdded.empty() && !aNext.mAdded.empty() &&
+		aNext.mAddedStart == mAddedEnd && aNext.mAddedEnd.mLine == mAddedEnd.mLine &&
+		aNext.mAdded.find('\n') == std::string::npos && !IsWordEnd(mAdded.back(), aNext.mAdded.front()))
+	{
+		mAdded += aNext.mAdded;
+		mAddedEnd = aNext.mAddedEnd;
+		mAfter = aNext.mAfter;
+		return true;
+	}
+
+	// a character erased right before the text erased so far, on the same line
+	if (mAdded.empty() && aNext.mAdded.empty() && !mRemoved.empty() && !aNext.mRemoved.empty() &&
+		aNext.mRemovedEnd == mRemovedStart && aNext.mRemovedStart.mLine == mRemovedStart.mLine &&
+		aNext.mRemoved.find('\n') == std::string::npos && !IsWordEnd(aNext.mRemoved.back(), mRemoved.front()))
+	{
+		mRemoved.insert(0, aNext.mRemoved);
+		mRemovedStart = aNext.mRemovedStart;
+		mAfter = aNext.mAfter;
+		return true;
+	}
+
+	return false;
+}
+
+void TextEditor::UndoRecord::Share(UndoArena& aArena)
+{
+	if (mAdded.size() >= UndoArena::SharedSize)
+	{
+		mAddedShared = aArena.Store(std::move(mAdded));
+		mAdded = std::string();
+	}
+	if (mRemoved.size() >= UndoArena::SharedSize)
+	{
+		mRemovedShared = aArena.Store(std::move(mRemoved));
+		mRemoved = std::string();
+	}
+	mAdded.shrink_to_fit();
+	mRemoved.shrink_to_fit();
+}
+
+size_t TextEditor::UndoRecord::GetMemorySize() const
+{
+	return sizeof(UndoRecord) + mAdded.capacity() + mRemoved.capacity();
+}
+
+size_t TextEditor::UndoRecord::GetReleasedSize() const
+{
+	// the arena only keeps weak references
+	const bool isSame = mAddedShared && mAddedShared == mRemovedShared;
+	size_t size = 0;
+	if (mAddedShared && mAddedShared.use_count() == (isSame ? 2 : 1))
+		size += mAddedShared->capacity();
+	if (mRemovedShared && !isSame && mRemovedShared.use_count() == 1)
+		size += mRemovedShared->capacity();
+	return size;
+}
+
+std::shared_ptr<const std::string> TextEditor::UndoArena::Store(std::string&& aText)
+{
+	const auto hash = std::hash<std::string>()(aText);
+	const auto range = mTexts.equal_range(hash);
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		auto text = it->second.lock();
+		if (text && *text == aText)
+			return text;
+	}
+
+	auto text = std::make_shared<const std::string>(std::move(aText));
+	mTexts.emplace(hash, text);
+	return text;
+}
+
+size_t TextEditor::UndoArena::GetSize()
+{
+	size_t size = 0;
+	for (auto it = mTexts.begin(); it != mTexts.end(); )
+	{
+		if (auto text = it->second.lock())
+		{
+			size += text->capacity();
+			++it;
+		}
+		else
+			it = mTexts.erase(it);
+	}
+	return size;
+}
+
 static bool TokenizeCStyleString(const char * in_begin, const char * in_end, const char *& out_begin, const char *& out_end)
 {
 	const char * p = in_begin;
@@ -2577,15 +3226,40 @@ static bool TokenizeCStyleCharacterLiteral(const char * in_begin, const char * i
 	return false;
 }
 
-static bool TokenizeCStyleIdentifier(const char * in_begin, const char * in_end, const char *& out_begin, const char *& out_end)
+static bool TokenizeCStyleNumber(const char * in_begin, const char * in_end, const char *& out_begin, const char *& out_end)
 {
 	const char * p = in_begin;
 
-	if ((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') || *p == '_')
+	const bool startsWithNumber = *p >= '0' && *p <= '9';
+
+	// fractional number without its integer part, as .5
+	if (*p == '.' && p + 1 < in_end && p[1] >= '0' && p[1] <= '9')
 	{
 		p++;
+		while (p < in_end && (*p >= '0' && *p <= '9'))
+			p++;
 
-		while ((p < in_end) && ((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') || (*p >= '0' && *p <= '9') || *p == '_'))
+		if (p < in_end && (*p == 'e' || *p == 'E'))
+		{
+			p++;
+
+			if (p < in_end && (*p == '+' || *p == '-'))
+				p++;
+
+			bool hasDigits = false;
+
+			while (p < in_end && (*p >= '0' && *p <= '9'))
+			{
+				hasDigits = true;
+
+				p++;
+			}
+
+			if (hasDigits == false)
+				return false;
+		}
+
+		if (p < in_end && (*p == 'f' || *p == 'F'))
 			p++;
 
 		out_begin = in_begin;
@@ -2593,15 +3267,6 @@ static bool TokenizeCStyleIdentifier(const char * in_begin, const char * in_end,
 		return true;
 	}
 
-	return false;
-}
-
-static bool TokenizeCStyleNumber(const char * in_begin, const char * in_end, const char *& out_begin, const char *& out_end)
-{
-	const char * p = in_begin;
-
-	const bool startsWithNumber = *p >= '0' && *p <= '9';
-
 	if (*p != '+' && *p != '-' && !startsWithNumber)
 		return false;
 
@@ -2700,42 +3365,114 @@ static bool TokenizeCStyleNumber(const char * in_begin, const char * in_end, con
 	return true;
 }
 
-static bool TokenizeCStylePunctuation(const char * in_begin, const char * in_end, const char *& out_begin, const char *& out_end)
-{
-	(void)in_end;
-
-	switch (*in_begin)
-	{
-	case '[':
-	case ']':
-	case '{':
-	case '}':
-	case '!':
-	case '%':
-	case '^':
-	case '&':
-	case '*':
-	case '(':
-	case ')':
-	case '-':
-	case '+':
-	case '=':
-	case '~':
-	case '|':
-	case '<':
-	case '>':
-	case '?':
-	case ':':
-	case '/':
-	case ';':
-	case ',':
-	case '.':
+// Character classes of the C style languages, deciding which token a character can start
+enum class CStyleCharClass : uint8_t { Other, Blank, Letter, Digit, Quote, Apostrophe, Sign, Dot, Hash, Punctuation };
+
+static const std::array<CStyleCharClass, 256>& CStyleCharClasses()
+{
+	static const auto classes = []()
+	{
+		std::array<CStyleCharClass, 256> table;
+		table.fill(CStyleCharClass::Other);
+		for (int c = 'a'; c <= 'z'; ++c)
+			table[c] = CStyleCharClass::Letter;
+		for (int c = 'A'; c <= 'Z'; ++c)
+			table[c] = CStyleCharClass::Letter;
+		table['_'] = CStyleCharClass::Letter;
+		for (int c = '0'; c <= '9'; ++c)
+			table[c] = CStyleCharClass::Digit;
+		for (const char * c = "[]{}!%^&*()=~|<>?:/;,"; *c; ++c)
+			table[(uint8_t)*c] = CStyleCharClass::Punctuation;
+		table[' '] = table['\t'] = CStyleCharClass::Blank;
+		table['"'] = CStyleCharClass::Quote;
+		table['\''] = CStyleCharClass::Apostrophe;
+		table['+'] = table['-'] = CStyleCharClass::Sign;
+		table['.'] = CStyleCharClass::Dot;
+		table['#'] = CStyleCharClass::Hash;
+		return table;
+	}();
+	return classes;
+}
+
+static bool TokenizeCStylePreprocessor(const char * in_begin, const char * in_end, const char *& out_begin, const char *& out_end)
+{
+	const auto& classes = CStyleCharClasses();
+	const char * p = in_begin + 1;
+
+	// # directive
+	while (p < in_end && classes[(uint8_t)*p] == CStyleCharClass::Blank)
+		p++;
+
+	const char * directive = p;
+	while (p < in_end && classes[(uint8_t)*p] == CStyleCharClass::Letter)
+		p++;
+
+	if (p == directive)
+		return false;
+
+	out_begin = in_begin;
+	out_end = p;
+	return true;
+}
+
+// Single pass lexer of the C style languages: the class of the first character selects the only rule which can match
+static bool TokenizeCStyle(const char * in_begin, const char * in_end, const char *& out_begin, const char *& out_end, TextEditor::PaletteIndex & paletteIndex)
+{
+	using PaletteIndex = TextEditor::PaletteIndex;
+	const auto& classes = CStyleCharClasses();
+
+	while (in_begin < in_end && classes[(uint8_t)*in_begin] == CStyleCharClass::Blank)
+		in_begin++;
+
+	if (in_begin == in_end)
+	{
+		out_begin = in_end;
+		out_end = in_end;
+		paletteIndex = PaletteIndex::Default;
+		return true;
+	}
+
+	switch (classes[(uint8_t)*in_begin])
+	{
+	case CStyleCharClass::Letter:
+	{
+		const char * p = in_begin + 1;
+		while (p < in_end && (classes[(uint8_t)*p] == CStyleCharClass::Letter || classes[(uint8_t)*p] == CStyleCharClass::Digit))
+			p++;
+		out_begin = in_begin;
+		out_end = p;
+		paletteIndex = PaletteIndex::Identifier;
+		return true;
+	}
+	case CStyleCharClass::Digit:
+		paletteIndex = PaletteIndex::Number;
+		return TokenizeCStyleNumber(in_begin, in_end, out_begin, out_end);
+	case CStyleCharClass::Quote:
+		paletteIndex = PaletteIndex::String;
+		return TokenizeCStyleString(in_begin, in_end, out_begin, out_end);
+	case CStyleCharClass::Apostrophe:
+		paletteIndex = PaletteIndex::CharLiteral;
+		return TokenizeCStyleCharacterLiteral(in_begin, in_end, out_begin, out_end);
+	case CStyleCharClass::Hash:
+		paletteIndex = PaletteIndex::Preprocessor;
+		return TokenizeCStylePreprocessor(in_begin, in_end, out_begin, out_end);
+	case CStyleCharClass::Sign:
+	case CStyleCharClass::Dot:
+		// a signed or fractional number, the operator otherwise
+		if (TokenizeCStyleNumber(in_begin, in_end, out_begin, out_end))
+		{
+			paletteIndex = PaletteIndex::Number;
+			return true;
+		}
+		// fall through
+	case CStyleCharClass::Punctuation:
 		out_begin = in_begin;
 		out_end = in_begin + 1;
+		paletteIndex = PaletteIndex::Punctuation;
 		return true;
+	default:
+		return false;
 	}
-
-	return false;
 }
 
 const TextEditor::LanguageDefinition& TextEditor::LanguageDefinition::CPlusPlus()
@@ -2766,32 +3503,7 @@ const TextEditor::LanguageDefinition& TextEditor::LanguageDefinition::CPlusPlus(
 			langDef.mIdentifiers.insert(std::make_pair(std::string(k), id));
 		}
 
-		langDef.mTokenize = [](const char * in_begin, const char * in_end, const char *& out_begin, const char *& out_end, PaletteIndex & paletteIndex) -> bool
-		{
-			paletteIndex = PaletteIndex::Max;
-
-			while (in_begin < in_end && isascii(*in_begin) && isblank(*in_begin))
-				in_begin++;
-
-			if (in_begin == in_end)
-			{
-				out_begin = in_end;
-				out_end = in_end;
-				paletteIndex = PaletteIndex::Default;
-			}
-			else if (TokenizeCStyleString(in_begin, in_end, out_begin, out_end))
-				paletteIndex = PaletteIndex::String;
-			else if (TokenizeCStyleCharacterLiteral(in_begin, in_end, out_begin, out_end))
-				paletteIndex = PaletteIndex::CharLiteral;
-			else if (TokenizeCStyleIdentifier(in_begin, in_end, out_begin, out_end))
-				paletteIndex = PaletteIndex::Identifier;
-			else if (TokenizeCStyleNumber(in_begin, in_end, out_begin, out_end))
-				paletteIndex = PaletteIndex::Number;
-			else if (TokenizeCStylePunctuation(in_begin, in_end, out_begin, out_end))
-				paletteIndex = PaletteIndex::Punctuation;
-
-			return paletteIndex != PaletteIndex::Max;
-		};
+		langDef.mTokenize = TokenizeCStyle;
 
 		langDef.mCommentStart = "/*";
 		langDef.mCommentEnd = "*/";
@@ -2904,15 +3616,7 @@ const TextEditor::LanguageDefinition& TextEditor::LanguageDefinition::GLSL()
 			langDef.mIdentifiers.insert(std::make_pair(std::string(k), id));
 		}
 
-		langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("[ \\t]*#[ \\t]*[a-zA-Z_]+", PaletteIndex::Preprocessor));
-		langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("L?\\\"(\\\\.|[^\\\"])*\\\"", PaletteIndex::String));
-		langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("\\'\\\\?[^\\']\\'", PaletteIndex::CharLiteral));
-		langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("[+-]?([0-9]+([.][0-9]*)?|[.][0-9]+)([eE][+-]?[0-9]+)?[fF]?", PaletteIndex::Number));
-		langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("[+-]?[0-9]+[Uu]?[lL]?[lL]?", PaletteIndex::Number));
-		langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("0[0-7]+[Uu]?[lL]?[lL]?", PaletteIndex::Number));
-		langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("0[xX][0-9a-fA-F]+[uU]?[lL]?[lL]?", PaletteIndex::Number));
-		langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("[a-zA-Z_][a-zA-Z0-9_]*", PaletteIndex::Identifier));
-		langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("[\\[\\]\\{\\}\\!\\%\\^\\&\\*\\(\\)\\-\\+\\=\\~\\|\\<\\>\\?\\/\\;\\,\\.]", PaletteIndex::Punctuation));
+		langDef.mTokenize = TokenizeCStyle;
 
 		langDef.mCommentStart = "/*";
 		langDef.mCommentEnd = "*/";
@@ -2953,32 +3657,7 @@ const TextEditor::LanguageDefinition& TextEditor::LanguageDefinition::C()
 			langDef.mIdentifiers.insert(std::make_pair(std::string(k), id));
 		}
 
-		langDef.mTokenize = [](const char * in_begin, const char * in_end, const char *& out_begin, const char *& out_end, PaletteIndex & paletteIndex) -> bool
-		{
-			paletteIndex = PaletteIndex::Max;
-
-			while (in_begin < in_end && isascii(*in_begin) && isblank(*in_begin))
-				in_begin++;
-
-			if (in_begin == in_end)
-			{
-				out_begin = in_end;
-				out_end = in_end;
-				paletteIndex = PaletteIndex::Default;
-			}
-			else if (TokenizeCStyleString(in_begin, in_end, out_begin, out_end))
-				paletteIndex = PaletteIndex::String;
-			else if (TokenizeCStyleCharacterLiteral(in_begin, in_end, out_begin, out_end))
-				paletteIndex = PaletteIndex::CharLiteral;
-			else if (TokenizeCStyleIdentifier(in_begin, in_end, out_begin, out_end))
-				paletteIndex = PaletteIndex::Identifier;
-			else if (TokenizeCStyleNumber(in_begin, in_end, out_begin, out_end))
-				paletteIndex = PaletteIndex::Number;
-			else if (TokenizeCStylePunctuation(in_begin, in_end, out_begin, out_end))
-				paletteIndex = PaletteIndex::Punctuation;
-
-			return paletteIndex != PaletteIndex::Max;
-		};
+		langDef.mTokenize = TokenizeCStyle;
 
 		langDef.mCommentStart = "/*";
 		langDef.mCommentEnd = "*/";
@@ -32,7 +32,9 @@
   #include <unistd.h>
 #endif
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <iostream>
 #include <filesystem>
 
@@ -46,10 +48,17 @@
 // DearIMGUI
 #include <imgui.h>
 
+#include "helpers/DrawBatcher.h"
+#include "helpers/FileWatcher.h"
 #include "helpers/HelpersImgui.h"
 #include "helpers/HelpersOpenGl.h"
 #include "helpers/Logger.h"
+#include "helpers/Mesh.h"
 #include "helpers/Renderer.h"
+#include "helpers/StateCache.h"
+#include "helpers/TextureResidency.h"
+#include "helpers/UniformBuffer.h"
+#include "helpers/ProgramBinaryCache.h"
 
 
 char PATH_EXECUTABLE[1024];
@@ -57,6 +66,8 @@ char PATH_EXECUTABLE[1024];
 static constexpr int SCREEN_WIDTH = 1600;
 static constexpr int SCREEN_HEIGHT = 900;
 
+static constexpr std::size_t TEXTURE_BUDGET = 256u * 1024u * 1024u; // video memory allowed to the textures
+
 static constexpr int OPENGL_MAJOR_VERSION = 3;
 static constexpr int OPENGL_MINOR_VERSION = 3;
 
@@ -67,12 +78,20 @@ static constexpr auto GLSL_VERSION = "#version 330 core";
 
 namespace test {
 
+  // Uniform block "Frame", declared by the shaders needing it
+  struct FrameUniforms_t {
+    helpers::opengl::std140::Mat4  projection;
+    helpers::opengl::std140::Float time;
+    float padding[3];
+  };
+  HELPERS_STD140_OFFSET(FrameUniforms_t, projection, 0);
+  HELPERS_STD140_OFFSET(FrameUniforms_t, time, 64);
+
   // Required element to draw the OpenGL test shapes
   struct Shape_t {
     std::shared_ptr<helpers::opengl::Program> pProgramShader;
-    GLuint hTexture = 0;
-    GLuint hVao = 0;  // a VAO is associated to a VBA stores all the vertex attributes in a single place    
-    unsigned nbIndices = 0;
+    std::shared_ptr<helpers::opengl::Texture> pTexture;
+    helpers::opengl::Mesh mesh;
   };
   // Sets the OpenGl shapes
   Shape_t SetUpQuad();
@@ -81,6 +100,51 @@ namespace test {
   // Sets Dear Imgui test window
   void Imgui_TestWindow();
 
+  // Compares drawing many quads one at a time and in instanced batches
+  class BenchmarkBatching
+  {
+  public:
+    static constexpr int MAX_NB_QUADS = 100000;
+
+    bool init();
+    // Renders the quads in the window and displays the measures
+    void draw();
+
+  private:
+    void drawPerItem();
+    void drawBatched();
+
+    helpers::imgui::WindowRender _window{ "Batching benchmark - render" };
+    std::shared_ptr<helpers::opengl::Program> _pProgramPerItem;
+    std::shared_ptr<helpers::opengl::Program> _pProgramBatched;
+    helpers::opengl::Mesh _quad;
+    helpers::opengl::DrawBatcher _batcher;
+    std::vector<helpers::opengl::DrawBatcher::Instance> _instances;
+    int  _nbQuads = 10000;
+    bool _isBatched = true;
+    std::size_t _nbDrawCalls = 0u;
+    double _submitMs = 0.0;   // CPU time spent submitting the quads
+  };
+
+  // Compares colorizing a large shader with the regular expressions and with the GLSL lexer
+  class BenchmarkColorizing
+  {
+  public:
+    // The source is repeated up to the number of lines to colorize
+    void init(const std::string& source);
+    void draw();
+
+  private:
+    void run();
+
+    std::string _source;
+    int _nbLines = 50000;
+    double _regexMs = 0.0;
+    double _lexerMs = 0.0;
+  };
+  // GLSL as it was colorized before the lexer
+  ImGuiColorTextEdit::TextEditor::LanguageDefinition GlslRegex();
+
 }
 
 
@@ -122,6 +186,7 @@ uint32_t len = sizeof(PATH_EXECUTABLE);
       return -1;
     }
     _renderer.setRunnable(this);
+    _statsWindow.setEventQueue(&_renderer.events());
 
     // # Init attributes
     bool success = _quadWindow.init();
@@ -159,16 +224,34 @@ uint32_t len = sizeof(PATH_EXECUTABLE);
     helpers::Logger::GetInstance()->warning("Test warning");
     helpers::Logger::GetInstance()->error("Test error");
     // # Example geometries
-    _quad = test::SetUpQuad();
+    helpers::opengl::TextureResidency::GetInstance().setBudget(TEXTURE_BUDGET);
     std::filesystem::path pathExe{ PATH_EXECUTABLE };
+    helpers::opengl::ProgramBinaryCache::GetInstance().setDirectory(pathExe.parent_path() / "shader_cache");
+    if (!_frameUniforms.init("Frame")) { // before building the programs using the block
+      return -1;
+    }
+    _quad = test::SetUpQuad();
     std::filesystem::path pathTexture = pathExe.parent_path() / "assets" / "texture.png";
-    auto pTexture = helpers::opengl::FactoryTexture::Create(pathTexture);
-    _quadWindow.setAspectRatio(float(pTexture->width()) / float(pTexture->height()));
-    _quad.hTexture = pTexture->handle();
+    _quad.pTexture = helpers::opengl::FactoryTexture::Create(pathTexture);
+    _quadWindow.setAspectRatio(float(_quad.pTexture->width()) / float(_quad.pTexture->height()));
     _triangle = test::SetUpTriangle();
+    _benchmark.init();
 
     
-    _fragshaderWindow.setSourceCode(_quad.pProgramShader->shader(GL_FRAGMENT_SHADER)->handle());
+    _shaderWorkspace.open(_quad.pProgramShader, "Van Gogh");
+    _shaderWorkspace.open(_triangle.pProgramShader, "Triangle");
+    _benchmarkColorizing.init(_quad.pProgramShader->shader(GL_FRAGMENT_SHADER)->source());
+
+    // # Shaders are reloaded when modified on disk
+    for (const auto& pProgram : { _quad.pProgramShader, _triangle.pProgramShader })
+    {
+      for (const int type : { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER })
+      {
+        for (const auto& path : pProgram->shader(type)->files()) { // including the #include files
+          _shaderWatcher.watch(path);
+        }
+      }
+    }
 
     // # Enter main loop
     _renderer.run();
@@ -179,6 +262,10 @@ uint32_t len = sizeof(PATH_EXECUTABLE);
 
 private:
 
+  // # Renderer
+  // destroyed last: the GL objects of the other members are deleted while its context exists
+  helpers::Renderer _renderer;
+
   // # Test elements
   const struct {
     float r = 0.2f;
@@ -191,63 +278,96 @@ private:
   test::Shape_t _quad;
   helpers::imgui::WindowRender _triangleWindow{ "Triangle" };
   test::Shape_t _triangle;
+  helpers::opengl::UniformBuffer<test::FrameUniforms_t> _frameUniforms;
 
-  helpers::imgui::WindowShader _fragshaderWindow{ "Van Gogh Fragment Shader" };
+  helpers::imgui::WindowWorkspace _shaderWorkspace{ "Shaders" };
 
-  helpers::imgui::Logger& _logger;
+  helpers::imgui::WindowStats _statsWindow{ "Stats" };
 
+  test::BenchmarkBatching _benchmark;
+  test::BenchmarkColorizing _benchmarkColorizing;
 
-  // # Renderer
-  helpers::Renderer _renderer;
+  helpers::FileWatcher _shaderWatcher;
+
+  helpers::imgui::Logger& _logger;
 
 private:
 
   virtual void renderFrame() override
   {
     // ## opengl main framebuffer
-    glClearColor(_colorBackground.r, _colorBackground.g, _colorBackground.b, _colorBackground.a);
+    auto& state = helpers::opengl::StateCache::GetInstance();
+    state.clearColor(_colorBackground.r, _colorBackground.g, _colorBackground.b, _colorBackground.a);
     glClear(GL_COLOR_BUFFER_BIT);
 
+    // ## Data shared by all the programs, uploaded once
+    test::FrameUniforms_t frame{};
+    frame.projection = glm::mat4{ 1.f };
+    frame.time = float(SDL_GetTicks()) / 1000.f;
+    _frameUniforms.update(frame);
 
-    // ## Fragment Shader Window
-    std::shared_ptr<helpers::opengl::Shader> pQuadShader = _quad.pProgramShader->shader(GL_FRAGMENT_SHADER);
-    bool bUpdated = _fragshaderWindow.draw();
-    if (bUpdated)
+    // ## Shader editors
+    // the programs whose shaders compiled are relinked: the previous ones are used until then
+    _shaderWorkspace.draw();
+
+    // ## Shaders modified on disk
+    std::filesystem::path pathModified;
+    while (_shaderWatcher.poll(pathModified))
     {
-      pQuadShader->compile(_fragshaderWindow.getSourceCode(), GL_FRAGMENT_SHADER);
-      _quad.pProgramShader->build();
+      _shaderWorkspace.reload(pathModified);
+      for (const auto& pProgram : { _quad.pProgramShader, _triangle.pProgramShader })
+      {
+        if (pProgram->reloadAsync(pathModified)) {
+          helpers::Logger::GetInstance()->info("Reloading " + pathModified.string());
+        }
+      }
     }
 
+    // ## Programs being built in the background
+    _quad.pProgramShader->poll();
+    _triangle.pProgramShader->poll();
+
     // ## Scenes
     // ### Sends the opengl commands into the helper windows 
     _quadWindow.begin();
-    glUseProgram(_quad.pProgramShader->handle());
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, _quad.hTexture);    
-    glBindVertexArray(_quad.hVao); // seeing as we only have a single VAO there's no need to bind it every time, but we'll do so to keep things a bit more organized
-    glDrawElements(GL_TRIANGLES, _quad.nbIndices, GL_UNSIGNED_INT, 0);
+    if (_quad.pProgramShader->isReady())
+    {
+      state.useProgram(_quad.pProgramShader->handle());
+      _quad.pProgramShader->setUniform("ourTexture", 0);
+      _quad.pTexture->bind(0);
+      _quad.mesh.draw();
+    }
     _quadWindow.end();
 
     _triangleWindow.begin();
-    glUseProgram(_triangle.pProgramShader->handle());
-    glBindVertexArray(_triangle.hVao); // seeing as we only have a single VAO there's no need to bind it every time, but we'll do so to keep things a bit more organized
-    glDrawElements(GL_TRIANGLES, _triangle.nbIndices, GL_UNSIGNED_INT, 0);
+    if (_triangle.pProgramShader->isReady())
+    {
+      state.useProgram(_triangle.pProgramShader->handle());
+      _triangle.mesh.draw();
+    }
     _triangleWindow.end();
     // ### draw the helper windows
     _quadWindow.draw();
     _triangleWindow.draw();
 
+    // ## Benchmarks
+    _benchmark.draw();
+    _benchmarkColorizing.draw();
+
     // ## Logger
     _logger.draw();
 
+    // ## Stats
+    _statsWindow.draw();
+
 
     // ## Test imgui window
     test::Imgui_TestWindow();
   }
 
-  virtual void processEvent(const SDL_Event events) override
+  virtual void processEvent(const SDL_Event& event) override
   {
-    (void)(events);
+    (void)(event);
   }
 
 };
@@ -268,29 +388,10 @@ int main(int argc, char *argv[])
 namespace test
 {
 
-  struct VertexCollection_t
-  {
-    enum eOPTIONS
-    {
-      NONE = 0,
-      HAS_COLOR = 1,
-      HAS_TEXTURE = 2
-    };
-
-    float* data = nullptr;
-    std::size_t sizeOfData = 0;
-    eOPTIONS options = NONE;
-  };
-
-  struct IndiceCollection_t
-  {
-    unsigned* data = nullptr;
-    std::size_t sizeOfData = 0;
-  };
-
+  template<typename Layout>
   Shape_t SetUpShape(
-                     const VertexCollection_t& vertices,
-                     const IndiceCollection_t& indices,
+                     const float* vertices, const std::size_t sizeOfVertices,
+                     const std::uint32_t* indices, const std::size_t nbIndices,
                      const std::filesystem::path& pathShaderVertex,
                      const std::filesystem::path& pathShaderFrag
                     )
@@ -299,63 +400,12 @@ namespace test
     const auto pShaderVertex = helpers::opengl::FactoryShader::Create(pathShaderVertex, GL_VERTEX_SHADER);
     const auto pShaderFragment = helpers::opengl::FactoryShader::Create(pathShaderFrag, GL_FRAGMENT_SHADER);
     const auto pProgram = helpers::opengl::FactoryProgram::Create(pShaderFragment, pShaderVertex);
-    pProgram->build();
-
-    unsigned int vbo, vao, ebo;
-    glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
-    glGenBuffers(1, &ebo);
-    // bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
-    glBindVertexArray(vao); // ebo will be hosted in the vao
-
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertices.sizeOfData, vertices.data, GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.sizeOfData, indices.data, GL_STATIC_DRAW);
-
-    // Configure and enable vertex attribute #0 ("location" 0 in the verter shader): vertex coordinates
-    GLuint location = 0;
-    std::intptr_t offset = 0;
-    GLsizei stride = 3 * sizeof(GL_FLOAT);
-    if(vertices.options & VertexCollection_t::HAS_COLOR)
-      stride += 3 * sizeof(GL_FLOAT);
-    if(vertices.options & VertexCollection_t::HAS_TEXTURE)
-      stride += 2 * sizeof(GL_FLOAT);
-
-    glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, stride, (void*)offset);
-    glEnableVertexAttribArray(location);
-    // color is always located BEFORE texture in the vertex buffer
-    if(vertices.options & VertexCollection_t::HAS_COLOR) {
-      // Configure and enable vertex attribute #1 ("location" 1 in the verter shader): vertex color
-      ++location;
-      offset += 3 * sizeof(GL_FLOAT);
-      glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, stride, (void*)offset);
-      glEnableVertexAttribArray(location);
-    }
-    if (vertices.options & VertexCollection_t::HAS_TEXTURE) {
-      // Configure and enable vertex attribute #1 ("location" 1 or 2 in the verter shader): vertex texture coordinates
-      ++location;
-      offset += 3 * sizeof(GL_FLOAT);
-      glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, stride, (void*)offset);
-      glEnableVertexAttribArray(location);
-    }
-
-    // note that this is allowed, the call to glVertexAttribPointer registered VBO as the vertex attribute's bound vertex buffer object so afterwards we can safely unbind
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    // You can unbind the VAO afterwards so other VAO calls won't accidentally modify this VAO, but this rarely happens. Modifying other
-    // VAOs requires a call to glBindVertexArray anyways so we generally don't unbind VAOs (nor VBOs) when it's not directly necessary.
-    glBindVertexArray(0);
-
-    const std::size_t nb_indices = indices.sizeOfData / sizeof(decltype(indices.data[0]));
+    pProgram->buildAsync(); // the shaders of all the shapes are compiled in parallel. Polled in renderFrame()
 
-    return {
-      pProgram,
-      0, // texture
-      vao,
-      static_cast<uint32_t>(nb_indices)
-    };
+    // Geometry: the attribute #i of the layout is bound to the location i of the vertex shader
+    Shape_t shape{ pProgram, nullptr, {} }; // no texture
+    shape.mesh.init<Layout>(vertices, sizeOfVertices, indices, nbIndices);
+    return shape;
   }
 
   Shape_t SetUpQuad()
@@ -375,14 +425,15 @@ namespace test
      -0.75f, -0.75f,  0.0f,  0.0f,  0.0f    // bottom left
     };
     // Referencing the vertices to share them between the two triangles
-    unsigned int indices[] = {  // note that we start from 0!
+    std::uint32_t indices[] = {  // note that we start from 0!
         0, 1, 3,  // first Triangle
         1, 2, 3   // second Triangle
     };
     
-    return SetUpShape({vertices, sizeof(vertices), VertexCollection_t::HAS_TEXTURE},
-                      {indices, sizeof(indices)},
-                      pathShaderVertex, pathShaderFragment);
+    using Layout = helpers::opengl::VertexLayout<helpers::opengl::Position, helpers::opengl::UV>;
+    return SetUpShape<Layout>(vertices, sizeof(vertices),
+                              indices, std::size(indices),
+                              pathShaderVertex, pathShaderFragment);
   }
 
   Shape_t SetUpTriangle()
@@ -401,13 +452,14 @@ namespace test
       0.0f,   1.0f,   0.0f,  0.0f,  0.0f,  1.0f   // top
     };
     // Referencing the vertices
-    unsigned int indices[] = {  // note that we start from 0!
+    std::uint32_t indices[] = {  // note that we start from 0!
       0, 1, 2,  // a bit useless here because only a single Triangle
     };
     
-    return SetUpShape({vertices, sizeof(vertices), VertexCollection_t::HAS_COLOR},
-                      {indices, sizeof(indices)},
-                      pathShaderVertex, pathShaderFragment);
+    using Layout = helpers::opengl::VertexLayout<helpers::opengl::Position, helpers::opengl::Color>;
+    return SetUpShape<Layout>(vertices, sizeof(vertices),
+                              indices, std::size(indices),
+                              pathShaderVertex, pathShaderFragment);
 
   }
 
@@ -418,4 +470,192 @@ namespace test
     ImGui::Text("HELLO WORLD");
     ImGui::End();
   }
+
+
+  bool BenchmarkBatching::init()
+  {
+    // the same shader, with and without instance attributes
+    std::filesystem::path pathExe{ PATH_EXECUTABLE };
+    const auto pathShaderVertex = pathExe.parent_path() / "shaders" / "instance.vert";
+    const auto pathShaderFragment = pathExe.parent_path() / "shaders" / "instance.frag";
+    const auto pShaderFragment = helpers::opengl::FactoryShader::Create(pathShaderFragment, GL_FRAGMENT_SHADER);
+    _pProgramPerItem = helpers::opengl::FactoryProgram::Create(pShaderFragment,
+      helpers::opengl::FactoryShader::Create(pathShaderVertex, GL_VERTEX_SHADER));
+    _pProgramBatched = helpers::opengl::FactoryProgram::Create(pShaderFragment,
+      helpers::opengl::FactoryShader::Create(pathShaderVertex, GL_VERTEX_SHADER, { { "INSTANCED", "1" } }));
+    _pProgramPerItem->buildAsync();
+    _pProgramBatched->buildAsync();
+
+    const float vertices[] = {
+      -0.5f, -0.5f, 0.0f,
+       0.5f, -0.5f, 0.0f,
+       0.5f,  0.5f, 0.0f,
+      -0.5f,  0.5f, 0.0f
+    };
+    const std::uint32_t indices[] = { 0, 1, 2,  2, 3, 0 };
+    using Layout = helpers::opengl::VertexLayout<helpers::opengl::Position>;
+    if (!_quad.init<Layout>(vertices, sizeof(vertices), indices, std::size(indices))) {
+      return false;
+    }
+
+    // a grid of small quads covering the viewport
+    int side = 1;
+    while (side * side < MAX_NB_QUADS) {
+      ++side;
+    }
+    const float size = 2.f / float(side);
+    _instances.resize(MAX_NB_QUADS);
+    for (int i = 0; i < MAX_NB_QUADS; ++i)
+    {
+      const int x = i % side;
+      const int y = i / side;
+      auto& instance = _instances[std::size_t(i)];
+      instance.model = glm::mat4{ 1.f };
+      instance.model[0][0] = 0.9f * size;
+      instance.model[1][1] = 0.9f * size;
+      instance.model[3] = glm::vec4{ -1.f + (float(x) + 0.5f) * size, -1.f + (float(y) + 0.5f) * size, 0.f, 1.f };
+      instance.color = glm::vec4{ float(x) / float(side), float(y) / float(side), 0.5f, 1.f };
+    }
+
+    return _window.init();
+  }
+
+
+  void BenchmarkBatching::draw()
+  {
+    _pProgramPerItem->poll();
+    _pProgramBatched->poll();
+
+    _window.begin();
+    const auto start = std::chrono::steady_clock::now();
+    if (_isBatched) {
+      drawBatched();
+    }
+    else {
+      drawPerItem();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    _submitMs = std::chrono::duration<double, std::milli>(end - start).count();
+    _window.end();
+    _window.draw();
+
+    if (ImGui::Begin("Batching benchmark"))
+    {
+      ImGui::SliderInt("Quads", &_nbQuads, 1, MAX_NB_QUADS);
+      ImGui::Checkbox("Batched", &_isBatched);
+      ImGui::Text("Draw calls: %u", unsigned(_nbDrawCalls));
+      ImGui::SameLine();
+      ImGui::Text("Submission: %.2f ms", _submitMs);
+      ImGui::SameLine();
+      ImGui::Text("Frame: %.2f ms", 1000.f / ImGui::GetIO().Framerate);
+    }
+    ImGui::End();
+  }
+
+
+  void BenchmarkBatching::drawPerItem()
+  {
+    _nbDrawCalls = 0u;
+    if (!_pProgramPerItem->isReady()) {
+      return;
+    }
+    helpers::opengl::StateCache::GetInstance().useProgram(_pProgramPerItem->handle());
+    for (int i = 0; i < _nbQuads; ++i)
+    {
+      const auto& instance = _instances[std::size_t(i)];
+      _pProgramPerItem->setUniform("iModel", instance.model);
+      _pProgramPerItem->setUniform("iColor", instance.color);
+      _quad.draw();
+      ++_nbDrawCalls;
+    }
+  }
+
+
+  void BenchmarkBatching::drawBatched()
+  {
+    if (!_pProgramBatched->isReady())
+    {
+      _nbDrawCalls = 0u;
+      return;
+    }
+    for (int i = 0; i < _nbQuads; ++i) {
+      _batcher.submit(*_pProgramBatched, _quad, 0u, _instances[std::size_t(i)]);
+    }
+    _batcher.flush();
+    _nbDrawCalls = _batcher.nbDrawCalls();
+  }
+
+
+  void BenchmarkColorizing::init(const std::string& source)
+  {
+    _source = source;
+    if (_source.empty() || _source.back() != '\n') {
+      _source += '\n';
+    }
+  }
+
+
+  void BenchmarkColorizing::draw()
+  {
+    if (ImGui::Begin("Colorizing benchmark"))
+    {
+      ImGui::SliderInt("Lines", &_nbLines, 1000, 200000);
+      if (ImGui::Button("Run")) {
+        run();
+      }
+      ImGui::Text("Regex: %.1f ms", _regexMs);
+      ImGui::SameLine();
+      ImGui::Text("Lexer: %.1f ms", _lexerMs);
+      if (_lexerMs > 0.0)
+      {
+        ImGui::SameLine();
+        ImGui::Text("Speed-up: x%.1f", _regexMs / _lexerMs);
+      }
+    }
+    ImGui::End();
+  }
+
+
+  void BenchmarkColorizing::run()
+  {
+    const auto nbSourceLines = std::count(_source.begin(), _source.end(), '\n');
+    std::string text;
+    text.reserve(_source.size() * std::size_t(_nbLines / nbSourceLines + 1));
+    for (int nbLines = 0; nbLines < _nbLines; nbLines += int(nbSourceLines)) {
+      text += _source;
+    }
+
+    const auto measure = [&text](const ImGuiColorTextEdit::TextEditor::LanguageDefinition& language)
+    {
+      ImGuiColorTextEdit::TextEditor editor;
+      editor.SetLanguageDefinition(language);
+      editor.SetText(text);
+      const auto start = std::chrono::steady_clock::now();
+      editor.ColorizeAll();
+      const auto end = std::chrono::steady_clock::now();
+      return std::chrono::duration<double, std::milli>(end - start).count();
+    };
+    _regexMs = measure(GlslRegex());
+    _lexerMs = measure(ImGuiColorTextEdit::TextEditor::LanguageDefinition::GLSL());
+  }
+
+
+  ImGuiColorTextEdit::TextEditor::LanguageDefinition GlslRegex()
+  {
+    using PaletteIndex = ImGuiColorTextEdit::TextEditor::PaletteIndex;
+    auto language = ImGuiColorTextEdit::TextEditor::LanguageDefinition::GLSL();
+    language.mTokenize = nullptr;
+    language.mTokenRegexStrings = {
+      { "[ \\t]*#[ \\t]*[a-zA-Z_]+", PaletteIndex::Preprocessor },
+      { "L?\\\"(\\\\.|[^\\\"])*\\\"", PaletteIndex::String },
+      { "\\'\\\\?[^\\']\\'", PaletteIndex::CharLiteral },
+      { "[+-]?([0-9]+([.][0-9]*)?|[.][0-9]+)([eE][+-]?[0-9]+)?[fF]?", PaletteIndex::Number },
+      { "[+-]?[0-9]+[Uu]?[lL]?[lL]?", PaletteIndex::Number },
+      { "0[0-7]+[Uu]?[lL]?[lL]?", PaletteIndex::Number },
+      { "0[xX][0-9a-fA-F]+[uU]?[lL]?[lL]?", PaletteIndex::Number },
+      { "[a-zA-Z_][a-zA-Z0-9_]*", PaletteIndex::Identifier },
+      { "[\\[\\]\\{\\}\\!\\%\\^\\&\\*\\(\\)\\-\\+\\=\\~\\|\\<\\>\\?\\/\\;\\,\\.]", PaletteIndex::Punctuation }
+    };
+    return language;
+  }
 }
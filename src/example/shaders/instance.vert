@@ -0,0 +1,27 @@
+#version 330 core
+
+// Compiled with INSTANCED to be drawn by helpers::opengl::DrawBatcher,
+// without to be drawn one quad at a time
+layout (location = 0) in vec3 aPos;
+#ifdef INSTANCED
+layout (location = 8) in mat4 iModel;
+layout (location = 12) in vec4 iColor;
+#else
+uniform mat4 iModel;
+uniform vec4 iColor;
+#endif
+
+// shared by all the programs, see helpers::opengl::UniformBuffer
+layout (std140) uniform Frame
+{
+   mat4 projection;
+   float time;
+};
+
+out vec4 ourColor;
+
+void main()
+{
+   gl_Position = projection * iModel * vec4(aPos, 1.0);
+   ourColor = iColor;
+}
@@ -0,0 +1,15 @@
+// Included by the fragment shaders
+
+// output to the buffer
+out vec4 FragColor;
+
+void writeColor(vec4 color)
+{
+   FragColor = color;
+}
+
+// RGB + alpha=1.0
+void writeColor(vec3 color)
+{
+   writeColor(vec4(color, 1.0));
+}
@@ -1,12 +1,11 @@
-#version 330 core
-
-in vec2 TexCoords;
-
-out vec4 FragColor;
-
-uniform sampler2D ourTexture;
-
-void main()
-{
-   FragColor = texture(ourTexture, TexCoords);
-}
\ No newline at end of file
+#version 330 core
+#include "output.glsl"
+
+in vec2 TexCoords;
+
+uniform sampler2D ourTexture;
+
+void main()
+{
+   writeColor(texture(ourTexture, TexCoords));
+}
@@ -1,13 +1,13 @@
-#version 330 core
-
-// every location must be declared with glVertexAttribPointer()
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec2 aTexCoords;
-
-out vec2 TexCoords;
-
-void main()
-{
-   gl_Position = vec4(aPos.x, aPos.y, aPos.z, 1.0);
-   TexCoords = aTexCoords;
+#version 330 core
+
+// every location must be declared with glVertexAttribPointer()
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTexCoords;
+
+out vec2 TexCoords;
+
+void main()
+{
+   gl_Position = vec4(aPos.x, aPos.y, aPos.z, 1.0);
+   TexCoords = aTexCoords;
 }
\ No newline at end of file
@@ -1,11 +1,10 @@
 #version 330 core
+#include "output.glsl"
 
 // input from the vertex shader
 in vec3 ourColor;
-// output to the buffer
-out vec4 FragColor;
 
 void main()
 {
-   FragColor = vec4(ourColor, 1.0); // RGB + alpha=1.0
-}
\ No newline at end of file
+   writeColor(ourColor);
+}
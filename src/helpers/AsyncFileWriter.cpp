@@ -0,0 +1,129 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <fstream>
+#include <system_error>
+
+#include "AsyncFileWriter.h"
+#include "Logger.h"
+
+
+namespace helpers
+{
+
+  AsyncFileWriter AsyncFileWriter::_Instance;
+
+
+  AsyncFileWriter::~AsyncFileWriter()
+  {
+    if (_worker.joinable())
+    {
+      Job stop;
+      stop.isStop = true;
+      _jobs.emplace_back(std::move(stop));
+      _worker.join();
+    }
+  }
+
+
+  bool AsyncFileWriter::write(const std::filesystem::path& path, std::string content, Callback onWritten)
+  {
+    if (path.empty())
+    {
+      Logger::GetInstance()->error("Cannot write a file without a path");
+      return false;
+    }
+
+    std::call_once(_started, [this]()
+      {
+        _worker = std::thread{ [this]()
+          {
+            for (auto job = _jobs.pop_front(); !job.isStop; job = _jobs.pop_front())
+            {
+              auto result = Write(job);
+              if (job.onWritten) {
+                _written.emplace_back(Written{ std::move(job.onWritten), std::move(result) });
+              }
+              else if (result.success) {
+                Logger::GetInstance()->info(result.message);
+              }
+              else {
+                Logger::GetInstance()->error(result.message);
+              }
+            }
+          }
+        };
+      }
+    );
+    _jobs.emplace_back(Job{ path, std::move(content), std::move(onWritten) });
+    return true;
+  }
+
+
+  void AsyncFileWriter::poll()
+  {
+    Written written;
+    while (_written.try_pop_front(written)) {
+      written.onWritten(written.result);
+    }
+  }
+
+
+  AsyncFileWriter::Result AsyncFileWriter::Write(const Job& job)
+  {
+    Result result;
+    result.path = job.path;
+
+    auto pathTemp = job.path;
+    pathTemp += ".tmp";   // in the same directory: the rename does not cross file systems
+
+    {
+      std::ofstream stream{ pathTemp, std::ios::out | std::ios::binary | std::ios::trunc };
+      stream.write(job.content.data(), static_cast<std::streamsize>(job.content.size()));
+      if (!stream.good())
+      {
+        result.message = "Cannot write " + pathTemp.string();
+        stream.close();
+        std::error_code error;
+        std::filesystem::remove(pathTemp, error);
+        return result;
+      }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(pathTemp, job.path, error);
+    if (error)
+    {
+      result.message = "Cannot replace " + job.path.string() + ": " + error.message();
+      std::filesystem::remove(pathTemp, error);
+      return result;
+    }
+    result.success = true;
+    result.message = job.path.string() + " written";
+    // to recognize the file written, when notified of its modification
+    result.time = std::filesystem::last_write_time(job.path, error);
+    result.size = job.content.size();
+    return result;
+  }
+
+} // helpers
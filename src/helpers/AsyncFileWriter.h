@@ -0,0 +1,104 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "TDequeConcurrent.h"
+
+
+namespace helpers
+{
+
+  /// @brief Writes files on a background thread, so that saving never stalls a frame
+  /// @details A file is written in a temporary file next to it, then renamed over it:
+  ///          the file is either fully replaced or left untouched, never half written.
+  ///          The writes are done in order. The pending ones are completed before exiting.
+  ///          Their results are reported on the thread calling poll().
+  class AsyncFileWriter
+  {
+  public:
+
+    static AsyncFileWriter& GetInstance() {
+      return _Instance;
+    }
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    /// @brief Outcome of a write
+    struct Result
+    {
+      std::filesystem::path path;
+      bool success = false;
+      std::string message;    ///< What was written, or why it failed
+      std::filesystem::file_time_type time;   ///< Last write time of the file written
+      std::uintmax_t size = 0u;               ///< Size of the file written
+    };
+    using Callback = std::function<void(const Result&)>;
+
+    /// @brief Enqueues the writing of a file
+    /// @param content Moved to the I/O thread
+    /// @param onWritten Called by poll() once the write is over. If empty, the result is logged.
+    /// @return false if the path is empty: nothing is written
+    bool write(const std::filesystem::path& path, std::string content, Callback onWritten = {});
+
+    /// @brief Calls back the writes completed since the previous call. To be called once per frame.
+    void poll();
+
+  private:
+
+    AsyncFileWriter() = default;
+    ~AsyncFileWriter();
+
+    struct Job
+    {
+      std::filesystem::path path;
+      std::string content;
+      Callback onWritten;
+      bool isStop = false;    ///< Stops the worker
+    };
+
+    struct Written
+    {
+      Callback onWritten;
+      Result result;
+    };
+
+    static Result Write(const Job& job);
+
+    TDequeConcurrent<Job> _jobs;
+    TDequeConcurrent<Written> _written;   ///< Results waiting for poll()
+    std::once_flag _started;
+    std::thread    _worker;    ///< Started by the first write
+
+    static AsyncFileWriter _Instance;
+  };
+
+} // helpers
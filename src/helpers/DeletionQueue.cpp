@@ -0,0 +1,184 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <cassert>
+#include <iostream>
+#include <utility>
+
+#include "DeletionQueue.h"
+#include "StateCache.h"
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    thread_local DeletionQueue::Node* DeletionQueue::_PSpareNodes = nullptr;
+
+
+    DeletionQueue::Node* DeletionQueue::acquireNode()
+    {
+      // the free nodes are taken all at once: unlike popping a single one, it cannot suffer from ABA
+      Node* pSpare = _PSpareNodes;
+      if (pSpare == nullptr) {
+        pSpare = _pFree.exchange(nullptr, std::memory_order_acquire);
+      }
+      if (pSpare == nullptr) {
+        return new Node{};
+      }
+      _PSpareNodes = pSpare->pNext;
+      return pSpare;
+    }
+
+
+    void DeletionQueue::push(const eObject type, const GLuint handle)
+    {
+      if (_isClosed.load(std::memory_order_acquire))
+      {
+        std::cerr << "OpenGL object " << handle << " released after the context was destroyed: leaked" << std::endl;
+        assert(false && "OpenGL object released after DeletionQueue::close()");
+        return;
+      }
+
+      Node* pNode = acquireNode();
+      pNode->type = type;
+      pNode->handle = handle;
+      pNode->pNext = _pHead.load(std::memory_order_relaxed);
+      while (!_pHead.compare_exchange_weak(pNode->pNext, pNode, std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+
+
+    void DeletionQueue::collect()
+    {
+      takePushed();
+
+      while (!_batches.empty())
+      {
+        const GLenum result = glClientWaitSync(_batches.front().fence, 0, 0u);
+        if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) {
+          break;  // the following batches are more recent
+        }
+        deleteBatch(_batches.front());
+        _batches.pop_front();
+      }
+    }
+
+
+    void DeletionQueue::flush()
+    {
+      takePushed();
+      for (auto& batch : _batches) {
+        deleteBatch(batch);
+      }
+      _batches.clear();
+    }
+
+
+    void DeletionQueue::close()
+    {
+      _isClosed.store(true, std::memory_order_release);
+      flush();
+    }
+
+
+    void DeletionQueue::takePushed()
+    {
+      // the consumer takes the whole stack at once: no ABA problem
+      Node* pNode = _pHead.exchange(nullptr, std::memory_order_acquire);
+      if (pNode == nullptr) {
+        return;
+      }
+
+      Batch batch;
+      Node* const pFirst = pNode;
+      Node* pLast = nullptr;
+      for (; pNode != nullptr; pNode = pNode->pNext)
+      {
+        batch.handles[std::size_t(pNode->type)].push_back(pNode->handle);
+        ++_nbPending;
+        pLast = pNode;
+      }
+      // the nodes are recycled: in steady state, releasing an object allocates nothing
+      pLast->pNext = _pFree.load(std::memory_order_relaxed);
+      while (!_pFree.compare_exchange_weak(pLast->pNext, pFirst, std::memory_order_release, std::memory_order_relaxed)) {}
+
+      batch.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+      _batches.emplace_back(std::move(batch));
+    }
+
+
+    void DeletionQueue::deleteBatch(Batch& batch)
+    {
+      if (batch.fence != nullptr) {
+        glDeleteSync(batch.fence);
+      }
+
+      // OpenGL unbinds the deleted objects and may reuse their names
+      auto& state = StateCache::GetInstance();
+      const auto& shaders = batch.handles[std::size_t(eObject::SHADER)];
+      const auto& programs = batch.handles[std::size_t(eObject::PROGRAM)];
+      const auto& textures = batch.handles[std::size_t(eObject::TEXTURE)];
+      const auto& buffers = batch.handles[std::size_t(eObject::BUFFER)];
+      const auto& vertexArrays = batch.handles[std::size_t(eObject::VERTEX_ARRAY)];
+      const auto& framebuffers = batch.handles[std::size_t(eObject::FRAMEBUFFER)];
+      const auto& renderbuffers = batch.handles[std::size_t(eObject::RENDERBUFFER)];
+
+      for (const auto shader : shaders) {
+        glDeleteShader(shader);
+      }
+      for (const auto program : programs)
+      {
+        state.forgetProgram(program);
+        glDeleteProgram(program);
+      }
+      for (const auto texture : textures) {
+        state.forgetTexture(texture);
+      }
+      for (const auto vao : vertexArrays) {
+        state.forgetVertexArray(vao);
+      }
+      for (const auto fbo : framebuffers) {
+        state.forgetFramebuffer(fbo);
+      }
+      for (const auto rbo : renderbuffers) {
+        state.forgetRenderbuffer(rbo);
+      }
+      glDeleteTextures(GLsizei(textures.size()), textures.data());
+      glDeleteBuffers(GLsizei(buffers.size()), buffers.data());
+      glDeleteVertexArrays(GLsizei(vertexArrays.size()), vertexArrays.data());
+      glDeleteFramebuffers(GLsizei(framebuffers.size()), framebuffers.data());
+      glDeleteRenderbuffers(GLsizei(renderbuffers.size()), renderbuffers.data());
+
+      std::size_t nbDeleted = 0u;
+      for (const auto& handles : batch.handles) {
+        nbDeleted += handles.size();
+      }
+      _nbPending -= nbDeleted;
+      _nbDeleted += nbDeleted;
+    }
+
+  } // opengl
+
+} // helpers
@@ -0,0 +1,128 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include <GL/glew.h>
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    /// @brief Defers the deletion of the OpenGL objects to the thread owning the context
+    /// @details The objects can be released from any thread: push() is lock-free and makes no OpenGL call.
+    ///          Once per frame, collect() fences the objects released since the previous frame and
+    ///          deletes, in batch, those whose fence has signaled: the GPU is done with them.
+    ///          The queue is never destroyed, so that objects released during the static destruction can still push.
+    class DeletionQueue
+    {
+    public:
+
+      enum class eObject : std::uint8_t
+      {
+        SHADER,
+        PROGRAM,
+        TEXTURE,
+        BUFFER,
+        VERTEX_ARRAY,
+        FRAMEBUFFER,
+        RENDERBUFFER,
+        NB_OBJECTS
+      };
+
+      static DeletionQueue& GetInstance() {
+        static DeletionQueue* const PInstance = new DeletionQueue{};
+        return *PInstance;
+      }
+
+      DeletionQueue(const DeletionQueue&) = delete;
+      DeletionQueue& operator=(const DeletionQueue&) = delete;
+
+      /// @brief Enqueues an object to delete. Thread safe.
+      void push(const eObject type, const GLuint handle);
+
+      /// @brief Fences the objects released since the last call and deletes the ones the GPU is done with
+      /// @details To be called once per frame by the thread owning the context
+      void collect();
+
+      /// @brief Deletes all the objects released without waiting
+      void flush();
+
+      /// @brief Flushes the queue for the last time, before destroying the context
+      /// @details An object released afterwards cannot be deleted anymore: it is reported as leaked.
+      void close();
+
+      /// @brief Number of objects waiting for their fence
+      inline std::size_t nbPending() const { return _nbPending; }
+      inline std::uint64_t nbDeleted() const { return _nbDeleted; }
+
+    private:
+
+      DeletionQueue() = default;
+      ~DeletionQueue() = delete;
+
+      /// @brief A released object, in a lock-free stack
+      struct Node
+      {
+        eObject type;
+        GLuint  handle;
+        Node*   pNext;
+      };
+
+      /// @brief Returns a node recycled by takePushed(), or a new one if there is none
+      Node* acquireNode();
+
+      /// @brief The objects released during a frame
+      struct Batch
+      {
+        GLsync fence = nullptr;
+        std::array<std::vector<GLuint>, std::size_t(eObject::NB_OBJECTS)> handles;
+      };
+
+      /// @brief Moves the objects pushed so far in a new batch
+      void takePushed();
+      void deleteBatch(Batch& batch);
+
+      std::atomic<Node*> _pHead{ nullptr };
+      std::atomic<Node*> _pFree{ nullptr };   ///< Nodes already taken, to be reused by push()
+      std::atomic<bool>  _isClosed{ false };
+      std::deque<Batch>  _batches;   ///< Oldest first
+      std::size_t   _nbPending = 0u;
+      std::uint64_t _nbDeleted = 0u;
+
+      static thread_local Node* _PSpareNodes;   ///< Nodes reserved by the calling thread, trivial to outlive the static destruction
+    };
+
+  } // opengl
+
+} // helpers
@@ -0,0 +1,149 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <algorithm>
+#include <functional>
+
+#include "DrawBatcher.h"
+#include "HelpersOpenGl.h"
+#include "Mesh.h"
+#include "StateCache.h"
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    void DrawBatcher::submit(const Program& program, const Mesh& mesh, const GLuint texture, const Instance& instance)
+    {
+      if (!program.isReady()) {
+        return;
+      }
+      _items.push_back({ program.handle(), texture, &mesh, static_cast<std::uint32_t>(_instances.size()) });
+      _instances.push_back(instance);
+    }
+
+
+    void DrawBatcher::flush()
+    {
+      _nbDrawCalls = 0u;
+      _nbItems = _items.size();
+      if (_items.empty()) {
+        return;
+      }
+
+      // group the items sharing their state, keeping the order of submission inside a group
+      std::stable_sort(_items.begin(), _items.end());
+
+      // the instances are written in the order of the sorted items, directly in the stream
+      if (_items.size() > _capacity)
+      {
+        _capacity = std::max(_items.size(), 2u * _capacity);
+        _stream.init(GL_ARRAY_BUFFER, _capacity * sizeof(Instance));
+      }
+      _stream.beginFrame();
+      const auto allocation = _stream.allocate(_items.size() * sizeof(Instance));
+      if (!allocation.isValid())
+      {
+        _items.clear();
+        _instances.clear();
+        return;
+      }
+      auto pInstances = static_cast<Instance*>(allocation.pData);
+      for (std::size_t i = 0u; i < _items.size(); ++i) {
+        pInstances[i] = _instances[_items[i].instance];
+      }
+      _stream.flush();
+      glBindBuffer(GL_ARRAY_BUFFER, _stream.handle());
+
+      // one draw call per group
+      auto& state = StateCache::GetInstance();
+      for (std::size_t first = 0u; first < _items.size(); )
+      {
+        const Item& item = _items[first];
+        std::size_t last = first + 1u;
+        while (last < _items.size() && item.isBatchable(_items[last])) {
+          ++last;
+        }
+
+        state.useProgram(item.program);
+        if (item.texture != 0u) {
+          state.bindTexture(item.texture, 0);
+        }
+        state.bindVertexArray(item.pMesh->vao());
+        declareInstances(allocation.offset + static_cast<GLintptr>(first * sizeof(Instance)));
+        glDrawElementsInstanced(GL_TRIANGLES, item.pMesh->nbIndices(), item.pMesh->indexType(), nullptr, static_cast<GLsizei>(last - first));
+        ++_nbDrawCalls;
+
+        first = last;
+      }
+      glBindBuffer(GL_ARRAY_BUFFER, 0u);
+      _stream.endFrame();
+
+      _items.clear();
+      _instances.clear();
+    }
+
+
+    bool DrawBatcher::Item::operator<(const Item& rhs) const
+    {
+      if (program != rhs.program) {
+        return program < rhs.program;
+      }
+      if (texture != rhs.texture) {
+        return texture < rhs.texture;
+      }
+      // the built-in < does not order unrelated pointers: std::less does
+      return std::less<const Mesh*>{}(pMesh, rhs.pMesh);
+    }
+
+
+    bool DrawBatcher::Item::isBatchable(const Item& rhs) const
+    {
+      return program == rhs.program && texture == rhs.texture && pMesh == rhs.pMesh;
+    }
+
+
+    void DrawBatcher::declareInstances(const GLintptr offset) const
+    {
+      // OpenGL 3.3 has no base instance: the attributes point to the first instance of the batch
+      static constexpr GLsizei Stride = sizeof(Instance);
+
+      for (GLuint column = 0u; column < 4u; ++column)
+      {
+        const GLuint location = INSTANCE_LOCATION + column;
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, Stride, reinterpret_cast<const void*>(offset + GLintptr(column * sizeof(glm::vec4))));
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1u);
+      }
+      const GLuint location = INSTANCE_LOCATION + 4u;
+      glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, Stride, reinterpret_cast<const void*>(offset + GLintptr(offsetof(Instance, color))));
+      glEnableVertexAttribArray(location);
+      glVertexAttribDivisor(location, 1u);
+    }
+
+  } // opengl
+
+} // helpers
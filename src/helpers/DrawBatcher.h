@@ -0,0 +1,112 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "StreamBuffer.h"
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    class Mesh;
+    class Program;
+
+    /// @brief Collects draw items and submits them in as few draw calls as possible
+    /// @details The items are sorted by program, texture and mesh. The items sharing all three
+    ///          are drawn by a single glDrawElementsInstanced, their instance data being read
+    ///          from a per-instance vertex buffer, streamed through a StreamBuffer.
+    ///          The vertex shader declares the instance attributes at INSTANCE_LOCATION:
+    ///          @code
+    ///          layout (location = 8) in mat4 iModel;   // locations 8 to 11
+    ///          layout (location = 12) in vec4 iColor;
+    ///          @endcode
+    class DrawBatcher
+    {
+    public:
+
+      /// @brief Per-instance data
+      struct Instance
+      {
+        glm::mat4 model;
+        glm::vec4 color;
+      };
+
+      static constexpr GLuint INSTANCE_LOCATION = 8u;
+
+      DrawBatcher() = default;
+      DrawBatcher(const DrawBatcher&) = delete;
+
+      DrawBatcher& operator=(const DrawBatcher&) = delete;
+
+      /// @brief Queues an item. The program and the mesh must outlive the next call to flush().
+      /// @param texture Bound to the unit 0, if not 0
+      void submit(const Program& program, const Mesh& mesh, const GLuint texture, const Instance& instance);
+
+      /// @brief Draws the queued items and empties the queue
+      void flush();
+
+      /// @brief Number of draw calls issued by the last flush
+      inline std::size_t nbDrawCalls() const { return _nbDrawCalls; }
+      /// @brief Number of items drawn by the last flush
+      inline std::size_t nbItems() const { return _nbItems; }
+
+    private:
+
+      struct Item
+      {
+        GLuint program;
+        GLuint texture;
+        const Mesh* pMesh;
+        std::uint32_t instance;  ///< Index in _instances
+
+        /// @brief Order of submission: the program changes the least often, the mesh the most
+        bool operator<(const Item& rhs) const;
+        bool isBatchable(const Item& rhs) const;
+      };
+
+      /// @brief Points the instance attributes of the bound vertex array to the first instance of a batch
+      /// @param offset Offset of the first instance in the stream buffer
+      void declareInstances(const GLintptr offset) const;
+
+      std::vector<Item>     _items;
+      std::vector<Instance> _instances;
+      StreamBuffer _stream;
+      std::size_t  _capacity = 0u;      ///< Number of instances the stream can hold per frame
+      std::size_t _nbDrawCalls = 0u;
+      std::size_t _nbItems = 0u;
+    };
+
+  } // opengl
+
+} // helpers
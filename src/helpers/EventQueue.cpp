@@ -0,0 +1,134 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <algorithm>
+
+#include "EventQueue.h"
+
+
+namespace helpers
+{
+
+  void EventQueue::setMainWindow(SDL_Window* pWindow)
+  {
+    _mainWindowId = SDL_GetWindowID(pWindow);
+    SDL_GetWindowSize(pWindow, &_width, &_height);
+  }
+
+
+  void EventQueue::poll()
+  {
+    _events.clear();
+    _isResized = false;
+    _nbReceived = 0u;
+
+    SDL_Event event;
+    std::uint32_t oldest = SDL_GetTicks();
+    while (SDL_PollEvent(&event))
+    {
+      ++_nbReceived;
+      oldest = std::min(oldest, static_cast<std::uint32_t>(event.common.timestamp));
+      if (handleMainWindow(event) || coalesce(event)) {
+        continue;
+      }
+      _events.push_back(event);
+    }
+    _latencyMs = SDL_GetTicks() - oldest;
+  }
+
+
+  bool EventQueue::coalesce(const SDL_Event& event)
+  {
+    if (_events.empty() || _events.back().type != event.type) {
+      return false;
+    }
+
+    auto& last = _events.back();
+    switch (event.type)
+    {
+    case SDL_MOUSEMOTION:
+      if (last.motion.windowID != event.motion.windowID || last.motion.which != event.motion.which
+        || last.motion.state != event.motion.state) {
+        return false; // a button was pressed or released in between
+      }
+      last.motion.x = event.motion.x;
+      last.motion.y = event.motion.y;
+      last.motion.xrel += event.motion.xrel;
+      last.motion.yrel += event.motion.yrel;
+      return true;
+
+    case SDL_MOUSEWHEEL:
+      if (last.wheel.windowID != event.wheel.windowID || last.wheel.which != event.wheel.which
+        || last.wheel.direction != event.wheel.direction) {
+        return false;
+      }
+      last.wheel.x += event.wheel.x;
+      last.wheel.y += event.wheel.y;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+      last.wheel.preciseX += event.wheel.preciseX;
+      last.wheel.preciseY += event.wheel.preciseY;
+#endif
+      return true;
+
+    default:
+      return false;
+    }
+  }
+
+
+  bool EventQueue::isMainWindowEvent(const SDL_Event& event) const
+  {
+    if (event.type == SDL_QUIT) {
+      return true;
+    }
+    return event.type == SDL_WINDOWEVENT && event.window.windowID == _mainWindowId
+      && (event.window.event == SDL_WINDOWEVENT_CLOSE || event.window.event == SDL_WINDOWEVENT_RESIZED);
+  }
+
+
+  bool EventQueue::handleMainWindow(const SDL_Event& event)
+  {
+    if (!isMainWindowEvent(event)) {
+      return false;
+    }
+    if (event.type == SDL_QUIT || event.window.event == SDL_WINDOWEVENT_CLOSE)
+    {
+      _isQuitRequested = true;
+      return false;
+    }
+
+    // only the last size of the frame matters
+    _width = event.window.data1;
+    _height = event.window.data2;
+    if (!_isResized)
+    {
+      _isResized = true;
+      _resize = _events.size();
+      return false;
+    }
+    _events[_resize].window.data1 = _width;
+    _events[_resize].window.data2 = _height;
+    return true;
+  }
+
+} // helpers
@@ -0,0 +1,90 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <SDL2/SDL.h>
+
+
+namespace helpers
+{
+
+  /// @brief Gathers the SDL events of a frame, coalescing the bursts
+  /// @details Consecutive mouse motions are merged in a single one, the relative motions summed.
+  ///          So are consecutive wheel events. The resizes of the main window are merged in the first one of the frame.
+  ///          The order of the other events is kept: a click still follows the motion leading to it.
+  ///          The events keep the timestamp of the oldest input merged in them, to measure the latency.
+  class EventQueue
+  {
+  public:
+
+    void setMainWindow(SDL_Window* pWindow);
+
+    /// @brief Polls all the pending events. To be called once per frame.
+    void poll();
+
+    /// @brief Events of the frame to dispatch, in order. Including the ones of the main window.
+    inline const std::vector<SDL_Event>& events() const { return _events; }
+
+    /// @brief True if the event is quitting, closing or resizing the main window
+    /// @details Handled by the renderer through the state of the queue: not to be dispatched to the application.
+    bool isMainWindowEvent(const SDL_Event& event) const;
+
+    /// @brief True if the application or its main window was closed
+    inline bool isQuitRequested() const { return _isQuitRequested; }
+
+    /// @brief True if the main window was resized during the frame
+    inline bool isResized() const { return _isResized; }
+    inline int width() const { return _width; }
+    inline int height() const { return _height; }
+
+    /// @brief Number of events received from SDL during the last frame
+    inline std::uint32_t nbReceived() const { return _nbReceived; }
+    /// @brief Number of events left to dispatch after coalescing, during the last frame
+    inline std::uint32_t nbDispatched() const { return static_cast<std::uint32_t>(_events.size()); }
+    /// @brief Age, in ms, of the oldest event of the last frame when it was polled
+    inline std::uint32_t latencyMs() const { return _latencyMs; }
+
+  private:
+
+    /// @brief Merges the event in the last one queued if possible
+    bool coalesce(const SDL_Event& event);
+    /// @brief Updates the state of the main window
+    /// @return true if the event was merged in the resize already queued
+    bool handleMainWindow(const SDL_Event& event);
+
+    std::vector<SDL_Event> _events;
+    std::size_t _resize = 0u;   ///< Index of the resize of the main window in _events, if _isResized
+    std::uint32_t _mainWindowId = 0u;
+    bool _isQuitRequested = false;
+    bool _isResized = false;
+    int  _width = 0;
+    int  _height = 0;
+    std::uint32_t _nbReceived = 0u;
+    std::uint32_t _latencyMs = 0u;
+  };
+
+} // helpers
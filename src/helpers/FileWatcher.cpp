@@ -0,0 +1,194 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifdef __linux__
+  #include <poll.h>
+  #include <sys/inotify.h>
+  #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "Logger.h"
+#include "FileWatcher.h"
+
+
+namespace helpers
+{
+
+#ifdef __linux__
+
+  FileWatcher::FileWatcher(const std::chrono::milliseconds debounce)
+    : _debounce{ debounce }
+  {
+    _fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (_fd < 0 || pipe(_pipeStop) != 0)
+    {
+      Logger::GetInstance()->error(std::string{ "Cannot watch files: " } + std::strerror(errno));
+      return;
+    }
+    _thread = std::thread{ &FileWatcher::run, this };
+  }
+
+
+  FileWatcher::~FileWatcher()
+  {
+    if (_thread.joinable())
+    {
+      const char stop = 0;
+      [[maybe_unused]] const auto written = write(_pipeStop[1], &stop, 1);
+      _thread.join();
+    }
+    for (const int fd : { _fd, _pipeStop[0], _pipeStop[1] })
+    {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+
+  bool FileWatcher::watch(const std::filesystem::path& path)
+  {
+    if (!_thread.joinable()) {
+      return false;
+    }
+
+    auto directory = path.parent_path();
+    if (directory.empty()) {
+      directory = ".";
+    }
+    const int wd = inotify_add_watch(_fd, directory.string().c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if (wd < 0)
+    {
+      Logger::GetInstance()->error("Cannot watch " + directory.string() + ": " + std::strerror(errno));
+      return false;
+    }
+
+    // the same directory always gets the same watch descriptor
+    std::lock_guard<std::mutex> lock{ _mutex };
+    auto& watched = _directories[wd];
+    watched.path = directory;
+    watched.files[path.filename().string()] = path;
+    return true;
+  }
+
+
+  void FileWatcher::run()
+  {
+    using clock = std::chrono::steady_clock;
+
+    while (true)
+    {
+      // wait for an event, or for the next pending change to become stable
+      int timeout = -1;
+      if (!_pending.empty())
+      {
+        auto next = clock::time_point::max();
+        for (const auto& change : _pending) {
+          next = std::min(next, change.second);
+        }
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(next - clock::now()).count();
+        timeout = static_cast<int>(std::max<long long>(remaining, 0));
+      }
+
+      pollfd fds[2] = { { _fd, POLLIN, 0 }, { _pipeStop[0], POLLIN, 0 } };
+      if (::poll(fds, 2, timeout) < 0 && errno != EINTR) {
+        Logger::GetInstance()->error(std::string{ "Cannot watch files: " } + std::strerror(errno));
+        return;
+      }
+      if (fds[1].revents != 0) {
+        return;
+      }
+      if (fds[0].revents & POLLIN) {
+        readEvents();
+      }
+
+      // publish the stable changes
+      const auto now = clock::now();
+      for (auto it = _pending.begin(); it != _pending.end(); )
+      {
+        if (it->second <= now)
+        {
+          _changes.emplace_back(it->first);
+          it = _pending.erase(it);
+        }
+        else {
+          ++it;
+        }
+      }
+    }
+  }
+
+
+  void FileWatcher::readEvents()
+  {
+    alignas(inotify_event) char buffer[4096];
+    ssize_t length;
+    while ((length = read(_fd, buffer, sizeof(buffer))) > 0)
+    {
+      std::lock_guard<std::mutex> lock{ _mutex };
+      for (char* ptr = buffer; ptr < buffer + length; )
+      {
+        const auto pEvent = reinterpret_cast<const inotify_event*>(ptr);
+        ptr += sizeof(inotify_event) + pEvent->len;
+
+        const auto itDir = _directories.find(pEvent->wd);
+        if (pEvent->len == 0 || itDir == _directories.end()) {
+          continue;
+        }
+        const auto itFile = itDir->second.files.find(pEvent->name);
+        if (itFile != itDir->second.files.end()) {
+          _pending[itFile->second] = std::chrono::steady_clock::now() + _debounce;
+        }
+      }
+    }
+  }
+
+#else
+
+  FileWatcher::FileWatcher(const std::chrono::milliseconds debounce)
+    : _debounce{ debounce }
+  { }
+
+
+  FileWatcher::~FileWatcher() = default;
+
+
+  bool FileWatcher::watch(const std::filesystem::path& path)
+  {
+    Logger::GetInstance()->info("File watching is not supported on this platform: " + path.string() + " is not watched");
+    return false;
+  }
+
+#endif
+
+
+  bool FileWatcher::poll(std::filesystem::path& path)
+  {
+    return _changes.try_pop_front(path);
+  }
+
+} // helpers
@@ -0,0 +1,91 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "TDequeConcurrent.h"
+
+
+namespace helpers
+{
+
+  /// @brief Watches files and reports their modifications
+  /// @details On Linux, the parent directories are watched with inotify by a background thread,
+  ///          so that the files replaced by a rename (as most editors do) are still detected.
+  ///          Bursts of modifications of a file are merged into a single change.
+  ///          On the other platforms, no change is ever reported.
+  class FileWatcher
+  {
+  public:
+
+    static constexpr std::chrono::milliseconds DEFAULT_DEBOUNCE{ 100 };
+
+    FileWatcher(const std::chrono::milliseconds debounce = DEFAULT_DEBOUNCE);
+    FileWatcher(const FileWatcher&) = delete;
+    ~FileWatcher();
+
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /// @brief Starts watching a file
+    /// @return false if the file cannot be watched
+    bool watch(const std::filesystem::path& path);
+
+    /// @brief Returns the next modified file, as given to watch(). Never blocks.
+    /// @return false if no file was modified
+    bool poll(std::filesystem::path& path);
+
+  private:
+
+    /// @brief Watched files of a directory
+    struct Directory
+    {
+      std::filesystem::path path;
+      std::unordered_map<std::string, std::filesystem::path> files; ///< File name -> path given to watch()
+    };
+
+    /// @brief Reads the inotify events and publishes the debounced changes
+    void run();
+    /// @brief Reads the pending inotify events
+    void readEvents();
+
+    const std::chrono::milliseconds _debounce;
+    int _fd = -1;             ///< inotify instance
+    int _pipeStop[2] = { -1, -1 }; ///< Written to stop the thread
+    std::thread _thread;
+
+    std::mutex _mutex;        ///< Protects _directories
+    std::unordered_map<int, Directory> _directories;  ///< Watch descriptor -> directory
+
+    std::map<std::filesystem::path, std::chrono::steady_clock::time_point> _pending; ///< Change -> time it becomes stable. Used by the thread only.
+    TDequeConcurrent<std::filesystem::path> _changes;
+  };
+
+} // helpers
@@ -0,0 +1,144 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#pragma once
+
+#include <utility>
+
+#include <GL/glew.h>
+
+#include "DeletionQueue.h"
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    /// @brief Owns an OpenGL object: deletes it when destroyed, never copied, moved without double deletes
+    /// @details Deleter releases the object and provides a static Create() to instanciate it.
+    ///          Converts implicitly to the raw handle, to be passed to the OpenGL functions.
+    ///          0 is the null handle of every type of object.
+    template<typename Deleter>
+    class GlHandle
+    {
+    public:
+
+      GlHandle() = default;
+      explicit GlHandle(const GLuint handle) : _handle{ handle } {}
+      GlHandle(const GlHandle&) = delete;
+      GlHandle(GlHandle&& rhs) noexcept : _handle{ rhs.release() } {}
+      ~GlHandle() { reset(); }
+
+      GlHandle& operator=(const GlHandle&) = delete;
+      GlHandle& operator=(GlHandle&& rhs) noexcept
+      {
+        if (this != &rhs) {
+          reset(rhs.release());
+        }
+        return *this;
+      }
+
+      /// @brief Instanciates a new object. The handle is null if the creation failed.
+      template<typename... Args>
+      static GlHandle Create(Args&&... args)
+      {
+        return GlHandle{ Deleter::Create(std::forward<Args>(args)...) };
+      }
+
+      /// @brief Deletes the object owned, if any, and takes the ownership of another one
+      inline void reset(const GLuint handle = 0u)
+      {
+        if (_handle != 0u) {
+          Deleter{}(_handle);
+        }
+        _handle = handle;
+      }
+
+      /// @brief Gives up the ownership of the object, without deleting it
+      inline GLuint release() { return std::exchange(_handle, 0u); }
+
+      inline GLuint get() const { return _handle; }
+      inline operator GLuint() const { return _handle; }
+
+    private:
+      GLuint _handle = 0u;
+    };
+
+
+    // The deleters hand the objects to the DeletionQueue: a handle can be released on any thread.
+
+    struct ShaderDeleter
+    {
+      static GLuint Create(const GLenum type) { return glCreateShader(type); }
+      void operator()(const GLuint handle) const { DeletionQueue::GetInstance().push(DeletionQueue::eObject::SHADER, handle); }
+    };
+
+    struct ProgramDeleter
+    {
+      static GLuint Create() { return glCreateProgram(); }
+      void operator()(const GLuint handle) const { DeletionQueue::GetInstance().push(DeletionQueue::eObject::PROGRAM, handle); }
+    };
+
+    struct TextureDeleter
+    {
+      static GLuint Create() { GLuint handle = 0u; glGenTextures(1, &handle); return handle; }
+      void operator()(const GLuint handle) const { DeletionQueue::GetInstance().push(DeletionQueue::eObject::TEXTURE, handle); }
+    };
+
+    struct BufferDeleter
+    {
+      static GLuint Create() { GLuint handle = 0u; glGenBuffers(1, &handle); return handle; }
+      void operator()(const GLuint handle) const { DeletionQueue::GetInstance().push(DeletionQueue::eObject::BUFFER, handle); }
+    };
+
+    struct VertexArrayDeleter
+    {
+      static GLuint Create() { GLuint handle = 0u; glGenVertexArrays(1, &handle); return handle; }
+      void operator()(const GLuint handle) const { DeletionQueue::GetInstance().push(DeletionQueue::eObject::VERTEX_ARRAY, handle); }
+    };
+
+    struct FramebufferDeleter
+    {
+      static GLuint Create() { GLuint handle = 0u; glGenFramebuffers(1, &handle); return handle; }
+      void operator()(const GLuint handle) const { DeletionQueue::GetInstance().push(DeletionQueue::eObject::FRAMEBUFFER, handle); }
+    };
+
+    struct RenderbufferDeleter
+    {
+      static GLuint Create() { GLuint handle = 0u; glGenRenderbuffers(1, &handle); return handle; }
+      void operator()(const GLuint handle) const { DeletionQueue::GetInstance().push(DeletionQueue::eObject::RENDERBUFFER, handle); }
+    };
+
+    using ShaderHandle = GlHandle<ShaderDeleter>;
+    using ProgramHandle = GlHandle<ProgramDeleter>;
+    using TextureHandle = GlHandle<TextureDeleter>;
+    using BufferHandle = GlHandle<BufferDeleter>;
+    using VertexArrayHandle = GlHandle<VertexArrayDeleter>;
+    using FramebufferHandle = GlHandle<FramebufferDeleter>;
+    using RenderbufferHandle = GlHandle<RenderbufferDeleter>;
+
+  } // opengl
+
+} // helpers
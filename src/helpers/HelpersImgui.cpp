@@ -1,391 +1,833 @@
-//MIT License
-//
-//Copyright(c) 2024
-//Christophe Meneboeuf <christophe@xtof.info>
-//
-//Permission is hereby granted, free of charge, to any person obtaining a copy
-//of this software and associated documentation files(the "Software"), to deal
-//in the Software without restriction, including without limitation the rights
-//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
-//copies of the Software, and to permit persons to whom the Software is
-//furnished to do so, subject to the following conditions :
-//
-//The above copyright notice and this permission notice shall be included in all
-//copies or substantial portions of the Software.
-//
-//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
-//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
-//SOFTWARE.
-
-#include <iostream>
-
-#include <GL/glew.h>
-
-#include <imgui/imgui_impl_opengl3.h>
-#include <imgui/imgui_impl_sdl2.h>
-
-#include <fstream>
-
-#include "HelpersImgui.h"
-
-
-namespace helpers
-{
-
-  namespace imgui
-  {
-
-   
-
-    WindowRender::~WindowRender()
-    {
-      if (_initialized)
-      {
-        glDeleteFramebuffers(1, &_frameBufferObject);
-        glDeleteRenderbuffers(1, &_renderBufferObject);
-        glDeleteTextures(1, &_texture);
-      }
-    }
-
-
-    bool WindowRender::init()
-    {
-      if (!_initialized)
-      {
-        _initialized = true;
-
-        glGenFramebuffers(1, &_frameBufferObject);
-        glGenTextures(1, &_texture);
-        glGenRenderbuffers(1, &_renderBufferObject); // render buffer object so OpenGl can do depth and stencil tests
-      }
-
-      return _initialized;
-    }
-
-  
-    void WindowRender::AspectRatio(ImGuiSizeCallbackData* data)
-    {
-
-        const float aspectRatio = *(float*)data->UserData;
-        if (aspectRatio != 0.f)
-        {
-          data->DesiredSize.y = (float)(int)(data->DesiredSize.x / aspectRatio);
-        }
-    }
-
-    void WindowRender::begin()
-    {
-      ImGui::SetNextWindowSizeConstraints(ImVec2(0, 0), ImVec2(FLT_MAX, FLT_MAX), AspectRatio, (void*)&_aspectRatio);
-      ImGui::Begin(_title.c_str());
-      _size = ImGui::GetContentRegionAvail();
-      ImGui::End();
-
-      // A minimal size is required for OpenGl 
-      const float x = std::max({ 1.f, _size.x });
-      const float y = std::max({ 1.f, _size.y });
-
-      glBindFramebuffer(GL_FRAMEBUFFER, _frameBufferObject); // now all ogl commands are from/to this framebuffer
-      glViewport(0, 0, int(x + 0.5f), int(y + 0.5f));
-
-      glBindTexture(GL_TEXTURE_2D, _texture); // all the following commands are related to this _texture
-      glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, int(x + 0.5f), int(y + 0.5f), 0, GL_RGB, GL_UNSIGNED_BYTE, NULL); //color _texture 
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-      glBindTexture(GL_TEXTURE_2D, 0); // unbind the _texture
-      glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _texture, 0); // attach the _texture to the binded framebuffer
-
-      glBindRenderbuffer(GL_RENDERBUFFER, _frameBufferObject);
-      glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, int(x + 0.5f), int(y + 0.5f));
-      glBindRenderbuffer(GL_RENDERBUFFER, 0);
-      glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, _frameBufferObject); // Render buffer object attached to the framebuffer
-
-      auto status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-      if (status != GL_FRAMEBUFFER_COMPLETE) // Sanity
-      {
-        std::cout << "ERROR::FRAMEBUFFER:: Framebuffer is not complete!" << std::endl;
-      }
-
-      glClearColor(0.f, 0.f, 0.f, 1.f);
-      glClear(GL_COLOR_BUFFER_BIT);
-    }
-
-    
-    void WindowRender::end()
-    {
-      glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    }
-
-    void WindowRender::draw()
-    {
-      ImGui::Begin(_title.c_str());
-      ImGui::Image((void*)(intptr_t)_texture, _size, { 0, 1 }, { 1, 0 }); // inverting UV to match OGL coordinates
-      ImGui::End();
-    }
-
-    Logger Logger::_Instance;
-
-    Logger::Logger()
-    {
-      _bAutoScroll = true;
-      clear();
-    }
-
-    void Logger::clear()
-    {
-      std::lock_guard<std::mutex> lock{ _mutex };
-      _buf.clear();
-      _lineOffsets.clear();
-      _lineOffsets.push_back(0);
-    }
-
-    void Logger::logDebug(const std::string& str)
-    {
-      const std::string info = "[debug]   " + str + '\n';
-      addLog("%s", info.c_str());
-    }
-
-    void Logger::logInfo(const std::string& str)
-    {
-      const std::string info = "[info]    " + str + '\n';
-      addLog("%s", info.c_str());
-    }
-
-    void Logger::logWarning(const std::string& str)
-    {
-      const std::string warn = "[warning] " + str + '\n';
-      addLog("%s", warn.c_str());
-    }
-
-    void Logger::logError(const std::string& str)
-    {
-      const std::string err = "[error]   " + str + '\n';
-      addLog("%s", err.c_str());
-    }
-
-    void Logger::addLog(const char* fmt, ...)
-    {
-      std::lock_guard<std::mutex> lock{ _mutex };
-      int old_size = _buf.size();
-      va_list args;
-      va_start(args, fmt);
-      _buf.appendfv(fmt, args);
-      va_end(args);
-      for (int new_size = _buf.size(); old_size < new_size; old_size++)
-        if (_buf[old_size] == '\n')
-          _lineOffsets.push_back(old_size + 1);
-    }
-
-
-    void    Logger::draw()
-    {
-      std::unique_lock<std::mutex> lock{ _mutex };
-      ImGuiTextBuffer buf{ _buf };
-      lock.unlock();
-
-      if (!ImGui::Begin(_title.c_str()))
-      {
-        ImGui::End();
-        return;
-      }
-
-      // Options menu
-      if (ImGui::BeginPopup("Options"))
-      {
-        ImGui::Checkbox("Auto-scroll", &_bAutoScroll);
-        ImGui::EndPopup();
-      }
-
-      // Main window
-      if (ImGui::Button("Options"))
-        ImGui::OpenPopup("Options");
-      ImGui::SameLine();
-      bool clear = ImGui::Button("Clear");
-      ImGui::SameLine();
-      bool copy = ImGui::Button("Copy");
-      ImGui::SameLine();
-      _filter.Draw("Filter", -100.0f);
-
-      ImGui::Separator();
-
-      if (ImGui::BeginChild("scrolling", ImVec2(0, 0), ImGuiChildFlags_None, ImGuiWindowFlags_HorizontalScrollbar))
-      {
-        if (clear)
-          this->clear();
-        if (copy)
-          ImGui::LogToClipboard();
-
-        ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 0));
-        const char* buf = _buf.begin();
-        const char* buf_end = _buf.end();
-        if (_filter.IsActive())
-        {
-          // In this example we don't use the clipper when _filter is enabled.
-          // This is because we don't have random access to the result of our filter.
-          // A real application processing logs with ten of thousands of entries may want to store the result of
-          // search/filter.. especially if the filtering function is not trivial (e.g. reg-exp).
-          for (int line_no = 0; line_no < _lineOffsets.Size; line_no++)
-          {
-            const char* line_start = buf + _lineOffsets[line_no];
-            const char* line_end = (line_no + 1 < _lineOffsets.Size) ? (buf + _lineOffsets[line_no + 1] - 1) : buf_end;
-            if (_filter.PassFilter(line_start, line_end))
-              ImGui::TextUnformatted(line_start, line_end);
-          }
-        }
-        else
-        {
-          // The simplest and easy way to display the entire buffer:
-          //   ImGui::TextUnformatted(buf_begin, buf_end);
-          // And it'll just work. TextUnformatted() has specialization for large blob of text and will fast-forward
-          // to skip non-visible lines. Here we instead demonstrate using the clipper to only process lines that are
-          // within the visible area.
-          // If you have tens of thousands of items and their processing cost is non-negligible, coarse clipping them
-          // on your side is recommended. Using ImGuiListClipper requires
-          // - A) random access into your data
-          // - B) items all being the  same height,
-          // both of which we can handle since we have an array pointing to the beginning of each line of text.
-          // When using the filter (in the block of code above) we don't have random access into the data to display
-          // anymore, which is why we don't use the clipper. Storing or skimming through the search result would make
-          // it possible (and would be recommended if you want to search through tens of thousands of entries).
-          ImGuiListClipper clipper;
-          clipper.Begin(_lineOffsets.Size);
-          while (clipper.Step())
-          {
-            for (int line_no = clipper.DisplayStart; line_no < clipper.DisplayEnd; line_no++)
-            {
-              const char* line_start = buf + _lineOffsets[line_no];
-              const char* line_end = (line_no + 1 < _lineOffsets.Size) ? (buf + _lineOffsets[line_no + 1] - 1) : buf_end;
-              ImGui::TextUnformatted(line_start, line_end);
-            }
-          }
-          clipper.End();
-        }
-        ImGui::PopStyleVar();
-
-        // Keep up at the bottom of the scroll region if we were already at the bottom at the beginning of the frame.
-        // Using a scrollbar or mouse-wheel will take away from the bottom edge.
-        if (_bAutoScroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY())
-          ImGui::SetScrollHereY(1.0f);
-      }
-      ImGui::EndChild();
-      ImGui::End();
-    }
-
-
-    using namespace ImGuiColorTextEdit;
-
-    WindowShader::WindowShader(const std::string& windowTitle)
-      : _title{ windowTitle }
-      , _src{ "" }
-      , _path{ "" }
-    {
-      _editor.SetLanguageDefinition(TextEditor::LanguageDefinition::GLSL());
-    }
-
-
-    bool WindowShader::init(const GLuint hShader)
-    {
-      if (hShader != 0)
-      {
-        _hShader = hShader;
-        GLsizei len;
-        glGetShaderSource(_hShader, MAX_SIZE_SRC, &len, _src);
-        if (glGetError() != GL_NO_ERROR)
-        {
-          return false;
-        }
-        _editor.SetText(_src);
-      }
-      else
-      {
-        _src[0] = '\0';
-      }
-      return true;
-    }
-
-
-
-    bool WindowShader::draw()
-    {
-      bool bUpdated = false;
-
-      if (ImGui::Begin(_title.c_str()))
-      {
-        bUpdated = ImGui::Button("UPDATE");
-        ImGui::SameLine();
-        const bool bCopy = ImGui::Button("Copy");
-        if (bUpdated || bCopy) {
-          strncpy(_src, _editor.GetText().c_str(), MAX_SIZE_SRC);
-          SDL_SetClipboardText(_src);
-        }
-        ImGui::InputText(" ", _path, IM_ARRAYSIZE(_path));
-        ImGui::SameLine();
-        if (ImGui::Button("SAVE")) {
-          saveSourceCode();
-        }
-
-        char buff[128];
-        std::snprintf(buff, 128, "%llu / %u", static_cast<unsigned long long>(std::strlen(_editor.GetText().c_str())), MAX_SIZE_SRC);
-        const std::size_t textWidth = ImGui::CalcTextSize(buff).x;
-        ImGui::SetCursorPosX(ImGui::GetWindowSize().x - std::ceil(ImGui::GetStyle().WindowPadding.x) - textWidth);
-        ImGui::Text("%s", buff);
-
-        _editor.Render(_title.c_str());
-      }
-
-      ImGui::End();
-
-      return bUpdated;
-    }
-
-
-    void WindowShader::setSourceCode(const GLuint shader)
-    {
-      glGetShaderSource(shader, MAX_SIZE_SRC, nullptr, _src);
-      _editor.SetText(_src);
-    }
-
-
-    void WindowShader::saveSourceCode()
-    {
-      const std::filesystem::path path{ _path };
-      strncpy(_src, _editor.GetText().c_str(), MAX_SIZE_SRC);
-
-      std::ofstream stream;
-      stream.open( path.string().c_str(), std::ios::out );
-      if (!stream.fail())    {
-        stream.write(_src, MAX_SIZE_SRC);
-        Logger::GetInstance().logInfo(path.string() + " written");
-      }
-      else   {
-        Logger::GetInstance().logError("Cannot open file " + path.string());      
-      }
-
-    }
-
-
-    void WindowShader::setPath(const std::filesystem::path& path)
-    {
-      strncpy(_path, path.string().c_str(), MAX_SIZE_PATH);
-      if (!std::filesystem::is_regular_file(path)) {
-        Logger::GetInstance().logInfo(path.string() + " is not a file");
-      }
-      else
-      {
-        std::ifstream stream{ path.string().c_str(), std::ios::in };
-        if (!stream.fail()) {
-          stream.read(_src, MAX_SIZE_SRC);
-          _editor.SetText(_src);
-        }
-        else {
-          Logger::GetInstance().logError("Cannot open file " + path.string());
-        }
-
-      }
-    }
-
-}
-}
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <iostream>
+
+#include <GL/glew.h>
+
+#include <imgui/imgui_impl_opengl3.h>
+#include <imgui/imgui_impl_sdl2.h>
+
+#include "AsyncFileWriter.h"
+#include "DeletionQueue.h"
+#include "HelpersImgui.h"
+#include "HelpersOpenGl.h"
+#include "MappedFile.h"
+#include "StateCache.h"
+#include "TextureResidency.h"
+
+
+namespace helpers
+{
+
+  namespace imgui
+  {
+
+    void Image(const opengl::TextureAtlas& atlas, const opengl::TextureAtlas::Id id, const ImVec2& size)
+    {
+      const auto& region = atlas.region(id);
+      if (region.isValid()) {
+        ImGui::Image((void*)(intptr_t)region.page, size, { region.u0, region.v0 }, { region.u1, region.v1 });
+      }
+      else {
+        ImGui::Dummy(size);
+      }
+    }
+
+   
+
+    bool WindowRender::init()
+    {
+      if (!_initialized)
+      {
+        _initialized = true;
+
+        _frameBufferObject = opengl::FramebufferHandle::Create();
+        _texture = opengl::TextureHandle::Create();
+        _renderBufferObject = opengl::RenderbufferHandle::Create(); // render buffer object so OpenGl can do depth and stencil tests
+      }
+
+      return _initialized;
+    }
+
+  
+    void WindowRender::AspectRatio(ImGuiSizeCallbackData* data)
+    {
+
+        const float aspectRatio = *(float*)data->UserData;
+        if (aspectRatio != 0.f)
+        {
+          data->DesiredSize.y = (float)(int)(data->DesiredSize.x / aspectRatio);
+        }
+    }
+
+    void WindowRender::begin()
+    {
+      ImGui::SetNextWindowSizeConstraints(ImVec2(0, 0), ImVec2(FLT_MAX, FLT_MAX), AspectRatio, (void*)&_aspectRatio);
+      ImGui::Begin(_title.c_str());
+      _size = ImGui::GetContentRegionAvail();
+      ImGui::End();
+
+      // A minimal size is required for OpenGl 
+      const float x = std::max({ 1.f, _size.x });
+      const float y = std::max({ 1.f, _size.y });
+
+      const int width = int(x + 0.5f);
+      const int height = int(y + 0.5f);
+
+      auto& state = opengl::StateCache::GetInstance();
+      state.bindFramebuffer(_frameBufferObject); // now all ogl commands are from/to this framebuffer
+      state.viewport(0, 0, width, height);
+
+      // the attachments are reallocated only when the window is resized
+      if (width != _width || height != _height)
+      {
+        _width = width;
+        _height = height;
+
+        state.bindTexture(_texture); // all the following commands are related to this _texture
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL); //color _texture 
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _texture, 0); // attach the _texture to the binded framebuffer
+
+        state.bindRenderbuffer(_renderBufferObject);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, _renderBufferObject); // Render buffer object attached to the framebuffer
+
+        auto status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        if (status != GL_FRAMEBUFFER_COMPLETE) // Sanity
+        {
+          std::cout << "ERROR::FRAMEBUFFER:: Framebuffer is not complete!" << std::endl;
+        }
+      }
+
+      state.clearColor(0.f, 0.f, 0.f, 1.f);
+      glClear(GL_COLOR_BUFFER_BIT);
+    }
+
+    
+    void WindowRender::end()
+    {
+      opengl::StateCache::GetInstance().bindFramebuffer(0);
+    }
+
+    void WindowRender::draw()
+    {
+      ImGui::Begin(_title.c_str());
+      ImGui::Image((void*)(intptr_t)_texture, _size, { 0, 1 }, { 1, 0 }); // inverting UV to match OGL coordinates
+      ImGui::End();
+    }
+
+    void WindowStats::draw()
+    {
+      if (ImGui::Begin(_title.c_str()))
+      {
+        drawTextures();
+        drawState();
+        drawInput();
+      }
+      ImGui::End();
+    }
+
+    void WindowStats::drawInput()
+    {
+      if (_pEvents == nullptr || !ImGui::CollapsingHeader("Input", ImGuiTreeNodeFlags_DefaultOpen)) {
+        return;
+      }
+
+      ImGui::Text("Events: %u", unsigned(_pEvents->nbReceived()));
+      ImGui::SameLine();
+      ImGui::Text("Dispatched: %u", unsigned(_pEvents->nbDispatched()));
+      ImGui::SameLine();
+      ImGui::Text("Latency: %u ms", unsigned(_pEvents->latencyMs()));
+    }
+
+    void WindowStats::drawState()
+    {
+      if (!ImGui::CollapsingHeader("OpenGL state", ImGuiTreeNodeFlags_DefaultOpen)) {
+        return;
+      }
+
+      const auto& state = opengl::StateCache::GetInstance();
+      ImGui::Text("Calls: %u", unsigned(state.nbCalls()));
+      ImGui::SameLine();
+      ImGui::Text("Avoided: %u", unsigned(state.nbAvoided()));
+
+      const auto& deletions = opengl::DeletionQueue::GetInstance();
+      ImGui::Text("Deletions pending: %u", unsigned(deletions.nbPending()));
+      ImGui::SameLine();
+      ImGui::Text("Deleted: %u", unsigned(deletions.nbDeleted()));
+    }
+
+    void WindowStats::drawTextures()
+    {
+      static constexpr std::size_t MEGABYTE = 1024u * 1024u;
+      static constexpr int MAX_BUDGET_MB = 4096;
+
+      if (!ImGui::CollapsingHeader("Textures", ImGuiTreeNodeFlags_DefaultOpen)) {
+        return;
+      }
+
+      auto& residency = opengl::TextureResidency::GetInstance();
+
+      // budget
+      int budgetMb = static_cast<int>(residency.budget() / MEGABYTE);
+      if (ImGui::SliderInt("Budget", &budgetMb, 0, MAX_BUDGET_MB, budgetMb == 0 ? "unlimited" : "%d MB")) {
+        residency.setBudget(static_cast<std::size_t>(budgetMb) * MEGABYTE);
+      }
+
+      // usage
+      const float usageMb = float(residency.usage()) / float(MEGABYTE);
+      char overlay[64];
+      if (residency.budget() == opengl::TextureResidency::NO_BUDGET)
+      {
+        std::snprintf(overlay, sizeof(overlay), "%.1f MB", usageMb);
+        ImGui::ProgressBar(0.f, ImVec2(-FLT_MIN, 0.f), overlay);
+      }
+      else
+      {
+        std::snprintf(overlay, sizeof(overlay), "%.1f / %d MB", usageMb, budgetMb);
+        ImGui::ProgressBar(float(residency.usage()) / float(residency.budget()), ImVec2(-FLT_MIN, 0.f), overlay);
+      }
+      ImGui::Text("Resident: %u / %u", unsigned(residency.nbResident()), unsigned(residency.nbTextures()));
+      ImGui::SameLine();
+      ImGui::Text("Evictions: %llu", static_cast<unsigned long long>(residency.nbEvictions()));
+      ImGui::SameLine();
+      ImGui::Text("Reloads: %llu", static_cast<unsigned long long>(residency.nbReloads()));
+
+      // resident textures, most recently used first
+      if (ImGui::BeginTable("residentTextures", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+      {
+        ImGui::TableSetupColumn("File");
+        ImGui::TableSetupColumn("Size");
+        ImGui::TableSetupColumn("KB");
+        ImGui::TableHeadersRow();
+        residency.forEachResident(
+          [](const opengl::Texture& texture)
+          {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(texture.path().filename().string().c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%d x %d", texture.width(), texture.height());
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", unsigned(texture.sizeInBytes() / 1024u));
+          }
+        );
+        ImGui::EndTable();
+      }
+    }
+
+
+    Logger Logger::_Instance;
+
+    Logger::Logger()
+    {
+      _bAutoScroll = true;
+      clear();
+    }
+
+    void Logger::clear()
+    {
+      std::lock_guard<std::mutex> lock{ _mutex };
+      _buf.clear();
+      _lineOffsets.clear();
+      _lineOffsets.push_back(0);
+    }
+
+    void Logger::logDebug(const std::string& str)
+    {
+      const std::string info = "[debug]   " + str + '\n';
+      addLog("%s", info.c_str());
+    }
+
+    void Logger::logInfo(const std::string& str)
+    {
+      const std::string info = "[info]    " + str + '\n';
+      addLog("%s", info.c_str());
+    }
+
+    void Logger::logWarning(const std::string& str)
+    {
+      const std::string warn = "[warning] " + str + '\n';
+      addLog("%s", warn.c_str());
+    }
+
+    void Logger::logError(const std::string& str)
+    {
+      const std::string err = "[error]   " + str + '\n';
+      addLog("%s", err.c_str());
+    }
+
+    void Logger::addLog(const char* fmt, ...)
+    {
+      std::lock_guard<std::mutex> lock{ _mutex };
+      int old_size = _buf.size();
+      va_list args;
+      va_start(args, fmt);
+      _buf.appendfv(fmt, args);
+      va_end(args);
+      for (int new_size = _buf.size(); old_size < new_size; old_size++)
+        if (_buf[old_size] == '\n')
+          _lineOffsets.push_back(old_size + 1);
+    }
+
+
+    void    Logger::draw()
+    {
+      std::unique_lock<std::mutex> lock{ _mutex };
+      ImGuiTextBuffer buf{ _buf };
+      lock.unlock();
+
+      if (!ImGui::Begin(_title.c_str()))
+      {
+        ImGui::End();
+        return;
+      }
+
+      // Options menu
+      if (ImGui::BeginPopup("Options"))
+      {
+        ImGui::Checkbox("Auto-scroll", &_bAutoScroll);
+        ImGui::EndPopup();
+      }
+
+      // Main window
+      if (ImGui::Button("Options"))
+        ImGui::OpenPopup("Options");
+      ImGui::SameLine();
+      bool clear = ImGui::Button("Clear");
+      ImGui::SameLine();
+      bool copy = ImGui::Button("Copy");
+      ImGui::SameLine();
+      _filter.Draw("Filter", -100.0f);
+
+      ImGui::Separator();
+
+      if (ImGui::BeginChild("scrolling", ImVec2(0, 0), ImGuiChildFlags_None, ImGuiWindowFlags_HorizontalScrollbar))
+      {
+        if (clear)
+          this->clear();
+        if (copy)
+          ImGui::LogToClipboard();
+
+        ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 0));
+        const char* buf = _buf.begin();
+        const char* buf_end = _buf.end();
+        if (_filter.IsActive())
+        {
+          // In this example we don't use the clipper when _filter is enabled.
+          // This is because we don't have random access to the result of our filter.
+          // A real application processing logs with ten of thousands of entries may want to store the result of
+          // search/filter.. especially if the filtering function is not trivial (e.g. reg-exp).
+          for (int line_no = 0; line_no < _lineOffsets.Size; line_no++)
+          {
+            const char* line_start = buf + _lineOffsets[line_no];
+            const char* line_end = (line_no + 1 < _lineOffsets.Size) ? (buf + _lineOffsets[line_no + 1] - 1) : buf_end;
+            if (_filter.PassFilter(line_start, line_end))
+              ImGui::TextUnformatted(line_start, line_end);
+          }
+        }
+        else
+        {
+          // The simplest and easy way to display the entire buffer:
+          //   ImGui::TextUnformatted(buf_begin, buf_end);
+          // And it'll just work. TextUnformatted() has specialization for large blob of text and will fast-forward
+          // to skip non-visible lines. Here we instead demonstrate using the clipper to only process lines that are
+          // within the visible area.
+          // If you have tens of thousands of items and their processing cost is non-negligible, coarse clipping them
+          // on your side is recommended. Using ImGuiListClipper requires
+          // - A) random access into your data
+          // - B) items all being the  same height,
+          // both of which we can handle since we have an array pointing to the beginning of each line of text.
+          // When using the filter (in the block of code above) we don't have random access into the data to display
+          // anymore, which is why we don't use the clipper. Storing or skimming through the search result would make
+          // it possible (and would be recommended if you want to search through tens of thousands of entries).
+          ImGuiListClipper clipper;
+          clipper.Begin(_lineOffsets.Size);
+          while (clipper.Step())
+          {
+            for (int line_no = clipper.DisplayStart; line_no < clipper.DisplayEnd; line_no++)
+            {
+              const char* line_start = buf + _lineOffsets[line_no];
+              const char* line_end = (line_no + 1 < _lineOffsets.Size) ? (buf + _lineOffsets[line_no + 1] - 1) : buf_end;
+              ImGui::TextUnformatted(line_start, line_end);
+            }
+          }
+          clipper.End();
+        }
+        ImGui::PopStyleVar();
+
+        // Keep up at the bottom of the scroll region if we were already at the bottom at the beginning of the frame.
+        // Using a scrollbar or mouse-wheel will take away from the bottom edge.
+        if (_bAutoScroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY())
+          ImGui::SetScrollHereY(1.0f);
+      }
+      ImGui::EndChild();
+      ImGui::End();
+    }
+
+
+    using namespace ImGuiColorTextEdit;
+
+    /// @brief Returns the complete source code of a shader
+    static std::string ShaderSource(const GLuint shader)
+    {
+      GLint length = 0; // including the null terminator
+      glGetShaderiv(shader, GL_SHADER_SOURCE_LENGTH, &length);
+      std::string source(static_cast<std::size_t>(std::max(length, 1)), '\0');
+      GLsizei written = 0;
+      glGetShaderSource(shader, static_cast<GLsizei>(source.size()), &written, source.data());
+      source.resize(static_cast<std::size_t>(written));
+      return source;
+    }
+
+
+    WindowShader::WindowShader(const std::string& windowTitle)
+      : _title{ windowTitle }
+    {
+      // built once for all the shader editors
+      static const auto LanguageGlsl = TextEditor::BuildLanguage(TextEditor::LanguageDefinition::GLSL());
+      _editor.SetLanguage(LanguageGlsl);
+    }
+
+
+    bool WindowShader::init(const GLuint hShader)
+    {
+      if (hShader != 0)
+      {
+        _hShader = hShader;
+        _src = ShaderSource(_hShader);
+        if (glGetError() != GL_NO_ERROR)
+        {
+          return false;
+        }
+        _editor.SetText(_src);
+        glGetShaderiv(_hShader, GL_SHADER_TYPE, &_type);
+      }
+      else
+      {
+        _src.clear();
+      }
+      _srcGeneration = _editor.GetTextGeneration();
+      setValidated();
+      return true;
+    }
+
+
+
+    bool WindowShader::draw()
+    {
+      bool bUpdated = false;
+
+      if (ImGui::Begin(_title.c_str())) {
+        bUpdated = drawContent();
+      }
+      else {
+        bUpdated = update();
+      }
+
+      ImGui::End();
+
+      return bUpdated;
+    }
+
+
+    bool WindowShader::drawContent()
+    {
+      reloadAfterSave();
+
+      const bool bUpdate = ImGui::Button("UPDATE");
+      ImGui::SameLine();
+      const bool bCopy = ImGui::Button("Copy");
+      if (bUpdate || bCopy) {
+        syncSource();
+        SDL_SetClipboardText(_src.c_str());
+      }
+      ImGui::InputText(" ", _path.data(), _path.capacity() + 1u, ImGuiInputTextFlags_CallbackResize, ResizePath, &_path);
+      ImGui::SameLine();
+      if (ImGui::Button("SAVE")) {
+        saveSourceCode();
+      }
+      if (_bStale)
+      {
+        ImGui::TextColored(ImVec4{ 1.f, 0.6f, 0.f, 1.f }, "Modified on disk: the edits are not applied");
+        ImGui::SameLine();
+        if (ImGui::Button("RELOAD")) {
+          loadText(std::move(_diskText));
+        }
+      }
+
+      char buff[128];
+      std::snprintf(buff, 128, "%llu bytes", static_cast<unsigned long long>(_editor.GetTextSize()));
+      const std::size_t textWidth = ImGui::CalcTextSize(buff).x;
+      ImGui::SetCursorPosX(ImGui::GetWindowSize().x - std::ceil(ImGui::GetStyle().WindowPadding.x) - textWidth);
+      ImGui::Text("%s", buff);
+
+      _editor.Render(_title.c_str());
+
+      return validate(bUpdate);
+    }
+
+
+    bool WindowShader::update()
+    {
+      reloadAfterSave();
+      _editor.ColorizeInBackground();
+      return validate(false);
+    }
+
+
+    void WindowShader::setSourceCode(const GLuint shader)
+    {
+      _src = ShaderSource(shader);
+      _editor.SetText(_src);
+      _srcGeneration = _editor.GetTextGeneration();
+      glGetShaderiv(shader, GL_SHADER_TYPE, &_type);
+      setValidated();
+    }
+
+
+    void WindowShader::setSourceCode(std::string source)
+    {
+      _src = std::move(source);
+      _editor.SetText(_src);
+      _srcGeneration = _editor.GetTextGeneration();
+      setValidated();
+    }
+
+
+    void WindowShader::setShader(const opengl::Shader& shader)
+    {
+      _type = shader.type();
+      _path = shader.path().string();
+      _defines = shader.defines();
+      loadText(shader.text());
+    }
+
+
+    void WindowShader::reload(const std::filesystem::path& path)
+    {
+      if (_path.empty() || std::filesystem::path{ _path }.lexically_normal() != path.lexically_normal()) {
+        return;
+      }
+      if (_pSaves->pending > 0u)
+      {
+        // maybe written by this window: checked once the writes are over
+        _pSaves->bReload = true;
+        return;
+      }
+      if (_pSaves->bWritten)
+      {
+        std::error_code error;
+        const auto time = std::filesystem::last_write_time(path, error);
+        const auto size = error ? 0u : std::filesystem::file_size(path, error);
+        if (!error && time == _pSaves->time && size == _pSaves->size) {
+          return; // the file as saved from this window
+        }
+      }
+      std::string text;
+      if (!opengl::ShaderPreprocessor::ReadFile(path, text)) {
+        return;
+      }
+
+      syncSource();
+      if (text == _src)
+      {
+        // the file holds the edited text
+        _savedGeneration = _editor.GetTextGeneration();
+        _bStale = false;
+      }
+      else if (_editor.GetTextGeneration() != _savedGeneration)
+      {
+        // the edits are not lost, the user chooses
+        _diskText = std::move(text);
+        _bStale = true;
+      }
+      else {
+        loadText(std::move(text));
+      }
+    }
+
+
+    void WindowShader::reloadAfterSave()
+    {
+      if (_pSaves->bReload && _pSaves->pending == 0u)
+      {
+        _pSaves->bReload = false;
+        reload(_path);
+      }
+    }
+
+
+    void WindowShader::loadText(std::string text)
+    {
+      _src = std::move(text);
+      _editor.SetText(_src);
+      _srcGeneration = _savedGeneration = _editor.GetTextGeneration();
+      _diskText.clear();
+      _bStale = false;
+      setValidated();
+    }
+
+
+    void WindowShader::saveSourceCode()
+    {
+      if (_path.empty())
+      {
+        Logger::GetInstance().logError("No path to save the shader to");
+        return;
+      }
+      syncSource();
+      // reported in the in-app logger once written
+      std::weak_ptr<Saves> pSaves = _pSaves;
+      const bool bWriting = AsyncFileWriter::GetInstance().write(std::filesystem::path{ _path }, _src, [pSaves](const AsyncFileWriter::Result& result)
+        {
+          if (const auto pSavesLocked = pSaves.lock())
+          {
+            --pSavesLocked->pending;
+            if (result.success)
+            {
+              pSavesLocked->bWritten = true;
+              pSavesLocked->time = result.time;
+              pSavesLocked->size = result.size;
+            }
+          }
+          if (result.success) {
+            Logger::GetInstance().logInfo(result.message);
+          }
+          else {
+            Logger::GetInstance().logError(result.message);
+          }
+        }
+      );
+      if (bWriting)
+      {
+        ++_pSaves->pending;
+        _savedGeneration = _editor.GetTextGeneration();
+      }
+    }
+
+
+    void WindowShader::setPath(const std::filesystem::path& path)
+    {
+      _path = path.string();
+      _pSaves->bWritten = false;
+      if (!std::filesystem::is_regular_file(path)) {
+        Logger::GetInstance().logInfo(path.string() + " is not a file");
+      }
+      else
+      {
+        // the editor is filled straight from the mapped file: the source is pulled only when needed
+        MappedFile file;
+        if (file.open(path))
+        {
+          _editor.SetText(file.data() != nullptr ? file.data() : "", file.size());
+          _src.clear();
+          _srcGeneration = 0u;
+        }
+        else {
+          Logger::GetInstance().logError("Cannot open file " + path.string());
+        }
+
+      }
+    }
+
+
+    void WindowShader::syncSource() const
+    {
+      if (_editor.GetTextGeneration() != _srcGeneration)
+      {
+        _src = _editor.GetText();
+        _srcGeneration = _editor.GetTextGeneration();
+      }
+    }
+
+
+    bool WindowShader::validate(const bool bNow)
+    {
+      if (_type != GL_VERTEX_SHADER && _type != GL_FRAGMENT_SHADER) {
+        return bNow;
+      }
+
+      const auto now = std::chrono::steady_clock::now();
+      const auto generation = _editor.GetTextGeneration();
+      if (generation != _editGeneration)
+      {
+        _editGeneration = generation;
+        _editTime = now;
+      }
+
+      // a newer source code supersedes the one being compiled
+      if (bNow || (generation != _validationGeneration && now - _editTime >= ValidationDelay))
+      {
+        // the edited text is preprocessed as the file would be: its includes are relative to the path
+        syncSource();
+        _validationGeneration = generation;   // not retried if the includes cannot be read
+        auto pShader = std::make_shared<opengl::Shader>();
+        if (pShader->init(_src, std::filesystem::path{ _path }, _type, _defines) && pShader->submit())
+        {
+          _pValidation = std::move(pShader);
+          _bLogErrors = bNow;
+        }
+      }
+
+      // never blocks if the driver compiles in parallel
+      if (_pValidation == nullptr || !_pValidation->isCompiled()) {
+        return false;
+      }
+      const auto pShader = std::move(_pValidation);
+      _editor.SetErrorMarkers(pShader->infoLogByLine());
+      if (!pShader->status())
+      {
+        if (_bLogErrors) {
+          Logger::GetInstance().logError("Shader compilation failed: " + pShader->infoLog());
+        }
+        return false;
+      }
+      _pShader = pShader;
+      // the file was modified on disk: the edits replace it only if UPDATE is pressed
+      return !_bStale || _bLogErrors;
+    }
+
+
+    void WindowShader::setValidated()
+    {
+      _editGeneration = _validationGeneration = _editor.GetTextGeneration();
+      _pValidation = nullptr;
+      _editor.SetErrorMarkers({});
+    }
+
+
+    int WindowShader::ResizePath(ImGuiInputTextCallbackData* data)
+    {
+      if (data->EventFlag == ImGuiInputTextFlags_CallbackResize)
+      {
+        auto pPath = static_cast<std::string*>(data->UserData);
+        pPath->resize(static_cast<std::size_t>(data->BufTextLen));
+        data->Buf = pPath->data();
+      }
+      return 0;
+    }
+
+
+    void WindowWorkspace::open(std::shared_ptr<opengl::Program> pProgram, const std::string& name)
+    {
+      for (const auto type : { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER })
+      {
+        const auto pShader = pProgram->shader(type);
+        if (pShader == nullptr) {
+          continue;
+        }
+        // the tabs are identified by the label after "##"
+        const std::string label = name + (type == GL_VERTEX_SHADER ? " vert" : " frag") + "##" + std::to_string(_documents.size());
+        auto pWindow = std::make_unique<WindowShader>(label);
+        pWindow->setShader(*pShader);
+        pWindow->setPalette(_palette);
+        _documents.push_back(Document{ pProgram, std::move(pWindow) });
+      }
+    }
+
+
+    void WindowWorkspace::draw()
+    {
+      using Clock = std::chrono::steady_clock;
+      using Milliseconds = std::chrono::duration<float, std::milli>;
+      const auto start = Clock::now();
+
+      // the selected document is drawn and colorized first
+      std::size_t selected = _documents.size();
+      if (ImGui::Begin(_title.c_str()))
+      {
+        // the palette is shared by all the editors
+        static const char* PaletteNames[] = { "Dark", "Light", "Retro blue" };
+        if (ImGui::Combo("Palette", &_paletteIndex, PaletteNames, IM_ARRAYSIZE(PaletteNames)))
+        {
+          switch (_paletteIndex)
+          {
+          case 1:  setPalette(TextEditor::GetLightPalette()); break;
+          case 2:  setPalette(TextEditor::GetRetroBluePalette()); break;
+          default: setPalette(TextEditor::GetDarkPalette()); break;
+          }
+        }
+
+        if (ImGui::BeginTabBar("Documents"))
+        {
+          for (std::size_t i = 0u; i < _documents.size(); ++i)
+          {
+            auto& document = _documents[i];
+            if (ImGui::BeginTabItem(document.pWindow->title().c_str()))
+            {
+              selected = i;
+              document.pWindow->setColorizeBudget(FrameBudget);
+              if (document.pWindow->drawContent()) {
+                document.pProgram->rebuildAsync(document.pWindow->getShader());
+              }
+              ImGui::EndTabItem();
+            }
+          }
+          ImGui::EndTabBar();
+        }
+      }
+      ImGui::End();
+
+      // the others share what is left of the budget, in turns
+      for (std::size_t n = 0u; n < _documents.size(); ++n)
+      {
+        const float budget = FrameBudget - Milliseconds{ Clock::now() - start }.count();
+        if (budget <= 0.f) {
+          break;
+        }
+        const auto i = _next;
+        _next = (_next + 1u) % _documents.size();
+        if (i == selected) {
+          continue;
+        }
+        auto& document = _documents[i];
+        document.pWindow->setColorizeBudget(budget);
+        if (document.pWindow->update()) {
+          document.pProgram->rebuildAsync(document.pWindow->getShader());
+        }
+      }
+    }
+
+
+    void WindowWorkspace::reload(const std::filesystem::path& path)
+    {
+      for (auto& document : _documents) {
+        document.pWindow->reload(path);
+      }
+    }
+
+
+    void WindowWorkspace::setPalette(const TextEditor::Palette& palette)
+    {
+      _palette = palette;
+      for (auto& document : _documents) {
+        document.pWindow->setPalette(palette);
+      }
+    }
+
+}
+}
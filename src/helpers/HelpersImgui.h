@@ -1,161 +1,352 @@
-//MIT License
-//
-//Copyright(c) 2024
-//Christophe Meneboeuf <christophe@xtof.info>
-//
-//Permission is hereby granted, free of charge, to any person obtaining a copy
-//of this software and associated documentation files(the "Software"), to deal
-//in the Software without restriction, including without limitation the rights
-//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
-//copies of the Software, and to permit persons to whom the Software is
-//furnished to do so, subject to the following conditions :
-//
-//The above copyright notice and this permission notice shall be included in all
-//copies or substantial portions of the Software.
-//
-//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
-//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
-//SOFTWARE.
-
-#pragma once
-
-#include <mutex>
-
-#include <SDL2/SDL.h>
-#include <SDL2/SDL_opengl.h>
-#include <SDL2/SDL_opengl_glext.h>
-
-#include <filesystem>
-
-#include <imgui.h>
-#include <ImGuiColorTextEdit/TextEditor.h>
-
-
-namespace helpers
-{
-
-  namespace imgui
-  {
-    
-    /// @brief an Imgui Window diplaying a rendered scene
-    class WindowRender
-    {
-    public:
-
-      WindowRender(const std::string& windowTitle)
-        : _title(windowTitle)
-      {}
-
-      ~WindowRender();
-
-      bool init();
-
-      /// @brief The window will "capture" the following OpenGl rendering command until the call of end()
-      void begin();
-
-      /// @brief Stops "capturing" the OpenGl commands
-      void end();
-
-      /// @brief Draws the window
-      void draw();
-
-      /// @brief Constrains the widow to the provided aspect ratio (x:y)
-      /// @details Set to 0 to deactivate
-      void setAspectRatio(const float aspectRatio)
-      {
-        _aspectRatio = aspectRatio;
-      }
-
-    private:
-      
-      /// @brief Calback to constrain aspect ratio
-      static void AspectRatio(ImGuiSizeCallbackData* data);
-
-
-      bool _initialized = false;
-      float _aspectRatio = 0.f;      
-
-      GLuint _frameBufferObject = 0;
-      GLuint _renderBufferObject = 0;
-      GLuint _texture = 0;
-
-      const std::string _title;
-      ImVec2            _size = { 640.f, 480.f };
-
-    };
-
-    class WindowShader
-    {
-    public:
-
-      WindowShader(const std::string& windowTitle);
-
-      bool init(const GLuint hShader);
-
-      /// @brief returns true if a new source code is available
-      bool draw();
-
-      inline const char* getSourceCode() const { return _src; }
-
-      void setSourceCode(const GLuint shader);
-
-      void saveSourceCode();
-
-      void setPath(const std::filesystem::path& path);
-
-    private:
-      ImGuiColorTextEdit::TextEditor _editor;
-
-      static constexpr int MAX_SIZE_SRC = 10 * 1024;
-      static constexpr int MAX_SIZE_PATH = 512;
-
-      const std::string _title;
-      char _src[MAX_SIZE_SRC];
-      char _path[MAX_SIZE_PATH];
-      GLuint _hShader = 0;
-
-    };
-    class Logger
-    {
-
-    public:
-      Logger();
-
-    static Logger& GetInstance() {
-        return _Instance;
-      }
-
-      void clear();      
-
-      void logDebug(const std::string& str);
-
-      void logInfo(const std::string& str);
-
-      void logWarning(const std::string& str);
-
-      void logError(const std::string& str);
-
-      void draw();
-
-    private:
-
-      void addLog(const char* fmt, ...) IM_FMTARGS(2);
-
-      static Logger _Instance;
-
-      ImGuiTextBuffer     _buf;
-      ImGuiTextFilter     _filter;
-      ImVector<int>       _lineOffsets; // Index to lines offset. We maintain this with AddLog() calls.
-      bool                _bAutoScroll;  // Keep scrolling if already at the bottom.
-      const std::string   _title{ "Logger" };
-
-      std::mutex _mutex;
-    };
-
-  }
-
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_opengl.h>
+#include <SDL2/SDL_opengl_glext.h>
+
+#include <filesystem>
+
+#include <imgui.h>
+#include <ImGuiColorTextEdit/TextEditor.h>
+
+#include "EventQueue.h"
+#include "GlHandle.h"
+#include "ShaderPreprocessor.h"
+#include "TextureAtlas.h"
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+    class Program;
+    class Shader;
+  }
+
+  namespace imgui
+  {
+
+    /// @brief Draws an image packed in a texture atlas
+    /// @details Images sharing an atlas page are batched in the same draw command.
+    ///          A blank space of the requested size is drawn until the image is packed.
+    void Image(const opengl::TextureAtlas& atlas, const opengl::TextureAtlas::Id id, const ImVec2& size);
+    
+    /// @brief an Imgui Window diplaying a rendered scene
+    class WindowRender
+    {
+    public:
+
+      WindowRender(const std::string& windowTitle)
+        : _title(windowTitle)
+      {}
+
+      bool init();
+
+      /// @brief The window will "capture" the following OpenGl rendering command until the call of end()
+      void begin();
+
+      /// @brief Stops "capturing" the OpenGl commands
+      void end();
+
+      /// @brief Draws the window
+      void draw();
+
+      /// @brief Constrains the widow to the provided aspect ratio (x:y)
+      /// @details Set to 0 to deactivate
+      void setAspectRatio(const float aspectRatio)
+      {
+        _aspectRatio = aspectRatio;
+      }
+
+    private:
+      
+      /// @brief Calback to constrain aspect ratio
+      static void AspectRatio(ImGuiSizeCallbackData* data);
+
+
+      bool _initialized = false;
+      float _aspectRatio = 0.f;      
+
+      opengl::FramebufferHandle  _frameBufferObject;
+      opengl::RenderbufferHandle _renderBufferObject;
+      opengl::TextureHandle      _texture;
+      int    _width = 0;   ///< Size of the attachments
+      int    _height = 0;
+
+      const std::string _title;
+      ImVec2            _size = { 640.f, 480.f };
+
+    };
+
+    class WindowShader
+    {
+    public:
+
+      WindowShader(const std::string& windowTitle);
+
+      bool init(const GLuint hShader);
+
+      /// @brief returns true if a new source code is available
+      /// @details The source code is compiled in the background once the typing pauses, or when UPDATE is pressed,
+      ///          and the errors are marked in the editor. A new source code is available only if it compiled.
+      ///          If the type of the shader is unknown, returns true when UPDATE is pressed.
+      bool draw();
+
+      /// @brief Draws the content of the window, inside the current window
+      /// @details Returns true if a new source code is available, as draw()
+      bool drawContent();
+
+      /// @brief Colorizes and checks the compilation in progress, for a window that is not drawn
+      /// @details Returns true if a new source code is available, as draw()
+      bool update();
+
+      inline const std::string& title() const
+      {
+        return _title;
+      }
+
+      /// @brief Sets the time given each frame to colorize the lines that are not visible
+      inline void setColorizeBudget(const float milliseconds)
+      {
+        _editor.SetColorizeBudget(milliseconds);
+      }
+
+      inline void setPalette(const ImGuiColorTextEdit::TextEditor::Palette& palette)
+      {
+        _editor.SetPalette(palette);
+      }
+
+      /// @brief Returns the last source code that compiled, already compiled. nullptr if none.
+      inline const std::shared_ptr<opengl::Shader>& getShader() const
+      {
+        return _pShader;
+      }
+
+      /// @brief Sets the type of the shader, required to compile the source code
+      /// @details Deduced from the shader given to init(), setSourceCode() or setShader()
+      /// @param type **GL_VERTEX_SHADER** or **GL_FRAGMENT_SHADER**
+      inline void setType(const int type)
+      {
+        _type = type;
+      }
+
+      /// @brief Returns the source code, as of the last edit
+      inline const std::string& getSourceCode() const
+      {
+        syncSource();
+        return _src;
+      }
+
+      void setSourceCode(const GLuint shader);
+      void setSourceCode(std::string source);
+
+      /// @brief Edits the text of a shader's file, as written before preprocessing
+      /// @details The edits are preprocessed with the shader's defines, the includes being relative to its path.
+      ///          SAVE writes the text back to the file.
+      void setShader(const opengl::Shader& shader);
+
+      /// @brief Refreshes the text if it was loaded from this file, modified on disk
+      /// @details If the text was edited since loaded or saved, the window only shows that the file was modified
+      ///          and the edits are not applied until UPDATE is pressed or the file is reloaded.
+      void reload(const std::filesystem::path& path);
+
+      /// @brief Writes the source code to the path, in the background
+      void saveSourceCode();
+
+      /// @brief Sets the path to save to and loads the source code from it, if it exists
+      void setPath(const std::filesystem::path& path);
+
+    private:
+
+      /// @brief Pulls the source code from the editor, if modified since the last call
+      void syncSource() const;
+      /// @brief Compiles the source code if modified, and checks the compilation in progress
+      /// @param bNow Compiles now, even if not modified, and logs the errors
+      /// @return true if a new source code compiled
+      bool validate(const bool bNow);
+      /// @brief The current source code is the one compiled: it is not validated
+      void setValidated();
+      /// @brief Replaces the text, as loaded or saved
+      void loadText(std::string text);
+      /// @brief Checks the file once written, if it was modified on disk while being saved
+      void reloadAfterSave();
+      /// @brief Resizes the path while it is typed
+      static int ResizePath(ImGuiInputTextCallbackData* data);
+
+      ImGuiColorTextEdit::TextEditor _editor;
+
+      const std::string _title;
+      mutable std::string _src;   ///< Pulled from the editor only when needed and modified
+      mutable std::uint64_t _srcGeneration = 0u;  ///< Generation of the editor's text in _src, 0 if not pulled yet
+      std::string _path;
+      GLuint _hShader = 0;
+      opengl::ShaderDefines _defines;   ///< Injected when compiling the source code
+
+      static constexpr std::chrono::milliseconds ValidationDelay{ 400 };  ///< Pause in the typing before compiling
+      int _type = 0;
+      std::uint64_t _editGeneration = 0u;       ///< Generation of the editor's text when last seen modified
+      std::chrono::steady_clock::time_point _editTime;
+      std::uint64_t _validationGeneration = 0u; ///< Generation of the editor's text last compiled
+      std::shared_ptr<opengl::Shader> _pValidation; ///< Being compiled
+      std::shared_ptr<opengl::Shader> _pShader;     ///< Last compiled successfully
+      bool _bLogErrors = false;   ///< The compilation was requested with UPDATE
+      std::uint64_t _savedGeneration = 0u;  ///< Generation of the editor's text when loaded or saved
+      std::string _diskText;      ///< Text modified on disk while edited
+      bool _bStale = false;       ///< The file was modified on disk while edited
+
+      /// @brief Writes by SAVE, shared with their completion callbacks
+      struct Saves
+      {
+        unsigned pending = 0u;      ///< Not completed yet
+        bool bWritten = false;      ///< A write succeeded: the time and size are the ones of the file it wrote
+        std::filesystem::file_time_type time;
+        std::uintmax_t size = 0u;
+        bool bReload = false;       ///< The file was modified on disk during a write
+      };
+      std::shared_ptr<Saves> _pSaves = std::make_shared<Saves>();
+
+    };
+
+    /// @brief an Imgui Window editing the shaders of several programs, a tab per shader
+    /// @details The editors share the GLSL language and the palette. Only the selected tab is drawn,
+    ///          the other editors are colorized in turns with what is left of the frame budget:
+    ///          many open shaders cost about as much as a single one.
+    ///          A program is relinked once one of its shaders compiled.
+    class WindowWorkspace
+    {
+    public:
+
+      WindowWorkspace(const std::string& windowTitle)
+        : _title(windowTitle)
+      {}
+
+      /// @brief Opens the vertex and the fragment shaders of a program
+      /// @param name Prefix of the tabs
+      void open(std::shared_ptr<opengl::Program> pProgram, const std::string& name);
+
+      void draw();
+
+      /// @brief Refreshes the documents of this file, modified on disk
+      /// @details A document with unsaved edits is only marked as modified on disk
+      void reload(const std::filesystem::path& path);
+
+      /// @brief Sets the palette of all the editors. Chosen in the window.
+      void setPalette(const ImGuiColorTextEdit::TextEditor::Palette& palette);
+
+    private:
+
+      static constexpr float FrameBudget = 4.f;  ///< Milliseconds of colorizing each frame, for all the editors
+
+      struct Document
+      {
+        std::shared_ptr<opengl::Program> pProgram;
+        std::unique_ptr<WindowShader> pWindow;
+      };
+
+      const std::string _title;
+      std::vector<Document> _documents;
+      std::size_t _next = 0u;   ///< Next document to be colorized in the background
+      ImGuiColorTextEdit::TextEditor::Palette _palette = ImGuiColorTextEdit::TextEditor::GetDarkPalette();
+      int _paletteIndex = 0;
+    };
+
+    /// @brief an Imgui Window displaying statistics about the OpenGl resources
+    class WindowStats
+    {
+    public:
+
+      WindowStats(const std::string& windowTitle)
+        : _title(windowTitle)
+      {}
+
+      /// @brief Draws the window
+      void draw();
+
+      /// @brief Displays the input statistics of this queue
+      inline void setEventQueue(const EventQueue* pEvents) { _pEvents = pEvents; }
+
+    private:
+
+      /// @brief Texture memory and budget
+      void drawTextures();
+      /// @brief Events received and dispatched, during the last frame
+      void drawInput();
+      /// @brief Calls to the driver, during the last frame
+      void drawState();
+
+      const std::string _title;
+      const EventQueue* _pEvents = nullptr;
+
+    };
+
+    class Logger
+    {
+
+    public:
+      Logger();
+
+    static Logger& GetInstance() {
+        return _Instance;
+      }
+
+      void clear();      
+
+      void logDebug(const std::string& str);
+
+      void logInfo(const std::string& str);
+
+      void logWarning(const std::string& str);
+
+      void logError(const std::string& str);
+
+      void draw();
+
+    private:
+
+      void addLog(const char* fmt, ...) IM_FMTARGS(2);
+
+      static Logger _Instance;
+
+      ImGuiTextBuffer     _buf;
+      ImGuiTextFilter     _filter;
+      ImVector<int>       _lineOffsets; // Index to lines offset. We maintain this with AddLog() calls.
+      bool                _bAutoScroll;  // Keep scrolling if already at the bottom.
+      const std::string   _title{ "Logger" };
+
+      std::mutex _mutex;
+    };
+
+  }
+
 }
\ No newline at end of file
@@ -1,282 +1,882 @@
-//MIT License
-//
-//Copyright(c) 2024
-//Christophe Meneboeuf <christophe@xtof.info>
-//
-//Permission is hereby granted, free of charge, to any person obtaining a copy
-//of this software and associated documentation files(the "Software"), to deal
-//in the Software without restriction, including without limitation the rights
-//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
-//copies of the Software, and to permit persons to whom the Software is
-//furnished to do so, subject to the following conditions :
-//
-//The above copyright notice and this permission notice shall be included in all
-//copies or substantial portions of the Software.
-//
-//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
-//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
-//SOFTWARE.
-
-
-#include <cassert>
-#include <fstream>
-#include <filesystem>
-
-#include <imgui.h>
-#include <imgui/imgui_impl_opengl3.h>
-#include <imgui/imgui_impl_sdl2.h>
-
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb/stb_image.h>
-
-#include "Logger.h"
-#include "HelpersOpenGl.h"
-
-namespace helpers
-{
-
-  namespace opengl
-  {
-
-    std::vector<std::string> GetErrors()
-    {
-      std::vector<std::string> errors;
-      GLenum err;
-      while ((err = glGetError()) != GL_NO_ERROR) {
-        std::string errorString;
-        switch (err) {
-        case GL_INVALID_ENUM:
-          errorString = "GL_INVALID_ENUM";
-          break;
-        case GL_INVALID_VALUE:
-          errorString = "GL_INVALID_VALUE";
-          break;
-        case GL_INVALID_OPERATION:
-          errorString = "GL_INVALID_OPERATION";
-          break;
-        case GL_INVALID_FRAMEBUFFER_OPERATION:
-          errorString = "GL_INVALID_FRAMEBUFFER_OPERATION";
-          break;
-        case GL_OUT_OF_MEMORY:
-          errorString = "GL_OUT_OF_MEMORY";
-          break;
-        default:
-          errorString = "Unknown Error";
-          break;
-
-        }
-        errors.push_back(errorString);
-
-      }
-      return errors;
-    }
-    
-
-    Texture::~Texture()
-    {
-      glDeleteTextures(1, &_handle);
-    }
-
-    bool Texture::init(const std::filesystem::path& path)
-    {
-      // load image
-      stbi_set_flip_vertically_on_load(1);
-      unsigned char* imageData = stbi_load(path.string().c_str(), &_width, &_height, NULL, 4);
-      if (imageData == nullptr) {
-        stbi_image_free(imageData);
-        _errors.push_back("Cannot load image " + path.string());
-        return false;
-      }
-
-      // prepare texture
-      glGenTextures(1, &_handle);
-      glBindTexture(GL_TEXTURE_2D, _handle);
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-      // load texture
-      glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-      glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, _width, _height, 0, GL_RGBA, GL_UNSIGNED_BYTE, imageData);
-      
-      // free resources
-      stbi_image_free(imageData);
-
-      const int result = glGetError();
-      _errors = GetErrors();
-      if (!_errors.empty()) {
-        return false;
-      }
-
-      _isInit = true;
-      return true;
-    }
-
-
-    std::shared_ptr<Texture> FactoryTexture::Create(const std::filesystem::path& path)
-    {
-      auto texture = std::make_shared<Texture>();
-      if (!texture->init(path))
-      {
-        const auto& errors = texture->errors();
-        if (!errors.empty())
-        {
-          std::string errMsg = "Cannot create texture " + path.string() + ':';
-          for (const auto& error : texture->errors()) {
-            errMsg += "\n\t" + error;
-          }
-          Logger::GetInstance()->error(errMsg);
-        }
-      }
-      return texture;
-    }
-
-
-    bool Shader::init(const std::filesystem::path& path, const int type)
-    {
-      const auto logger = helpers::Logger::GetInstance();
-
-      if (_type != NO_TYPE)
-      {
-        logger->error("Shader is already initialized");
-        return false;
-      }
-
-      // read source file
-      std::ifstream streamInVertex{ path };
-      if (!streamInVertex.good()) {
-        logger->error("Cannot open file " + path.string());
-        return false;
-      }
-      std::string strSrc{ std::istreambuf_iterator<char>{streamInVertex}, {} };
-
-      // create resource
-      _handle = glCreateShader(type);
-      if (_handle == 0)
-      {
-        logger->error("An error occured while creating a the shader");
-        return false;
-      }   
-
-      // init
-      if (compile(strSrc, type))
-      {
-        _type = type;
-        return true;
-      }
-      else {
-        return false;
-      }
-    }
-     
-
-    bool Shader::compile(const std::string& source, const int type)
-    {
-
-      assert(_handle != 0);
-
-      const auto src = source.c_str();
-      const auto logger = helpers::Logger::GetInstance();
-
-      glShaderSource(_handle, 1, &src, NULL);
-      glCompileShader(_handle);
-
-      // check compilation errors
-      int success;
-      char info_log[512];
-      glGetShaderiv(_handle, GL_COMPILE_STATUS, &success);
-      if (!success)
-      {
-        glGetShaderInfoLog(_handle, 512, NULL, info_log);
-        logger->error("Shader compilation failed: " + std::string{ info_log });
-        return false;
-      }
-
-      return true;    
-    }
-
-
-    std::shared_ptr<Shader> FactoryShader::Create(const std::filesystem::path& path, const int type)
-    {
-      auto shader = std::make_shared<Shader>();
-      shader->init(path, type);
-      return shader;
-    }
-
-
-
-
-    Program::Program(std::shared_ptr<Shader> pFragShader, std::shared_ptr<Shader> pVertShader, ILogger* pLogger)
-      : _pFragShader{pFragShader}
-      , _pVertShader{pVertShader}
-      , _pLogger{&_loggerDefault}
-    {
-      if (pLogger != nullptr)
-        _pLogger = pLogger;
-    }
-
-
-    Program::~Program()
-    {
-      if (_handle != 0)
-        glDeleteProgram(_handle);
-    }
-
-    bool Program::init()
-    {
-      _handle = glCreateProgram();
-      if(_handle != 0)
-      {
-        glAttachShader(_handle, _pFragShader->handle());
-        glAttachShader(_handle, _pVertShader->handle());
-      }
-      return _handle != 0;
-    }
-
-
-    bool Program::build()
-    {
-      // link shaders into the program
-      glLinkProgram(_handle);
-      // check for linking errors
-      int success;
-      static char Info_Log[512];
-      glGetProgramiv(_handle, GL_LINK_STATUS, &success);
-      if (!success) {
-        glGetProgramInfoLog(_handle, 512, NULL, Info_Log);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << Info_Log << std::endl;
-      }
-
-      return true;
-    }
-
-    std::shared_ptr<Shader> Program::shader(const int type)
-    {
-      switch (type)
-      {
-      case GL_VERTEX_SHADER:
-        return _pVertShader;
-        break;
-      case GL_FRAGMENT_SHADER:
-        return _pFragShader;
-        break;
-      default:
-        _pLogger->logError("Type must be GL_VERTEX_SHADER or GL_FRAGMENT_SHADER");
-        _pLogger->logInfo("Returning type GL_FRAGMENT_SHADER by default");
-        return _pFragShader; // Or something invalid?
-        break;
-      }
-    }
-
-
-    std::shared_ptr<Program> FactoryProgram::Create(std::shared_ptr<Shader> pFragShader, std::shared_ptr<Shader> pVertShader)
-    {
-      auto pProgram = std::make_shared<Program>(pFragShader, pVertShader);
-      pProgram->init();
-      return pProgram;
-    }
-
-} // opengl
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+
+#include <imgui.h>
+#include <imgui/imgui_impl_opengl3.h>
+#include <imgui/imgui_impl_sdl2.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+
+#include "Logger.h"
+#include "HelpersOpenGl.h"
+#include "TextureResidency.h"
+#include "ProgramBinaryCache.h"
+#include "StateCache.h"
+#include "UniformBuffer.h"
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    std::vector<std::string> GetErrors()
+    {
+      std::vector<std::string> errors;
+      GLenum err;
+      while ((err = glGetError()) != GL_NO_ERROR) {
+        std::string errorString;
+        switch (err) {
+        case GL_INVALID_ENUM:
+          errorString = "GL_INVALID_ENUM";
+          break;
+        case GL_INVALID_VALUE:
+          errorString = "GL_INVALID_VALUE";
+          break;
+        case GL_INVALID_OPERATION:
+          errorString = "GL_INVALID_OPERATION";
+          break;
+        case GL_INVALID_FRAMEBUFFER_OPERATION:
+          errorString = "GL_INVALID_FRAMEBUFFER_OPERATION";
+          break;
+        case GL_OUT_OF_MEMORY:
+          errorString = "GL_OUT_OF_MEMORY";
+          break;
+        default:
+          errorString = "Unknown Error";
+          break;
+
+        }
+        errors.push_back(errorString);
+
+      }
+      return errors;
+    }
+
+
+    void EnableParallelShaderCompile()
+    {
+      // 0xFFFFFFFF lets the implementation choose the number of threads
+      if (GLEW_KHR_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+        Logger::GetInstance()->info("Parallel shader compilation enabled");
+      }
+      else if (GLEW_ARB_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+        Logger::GetInstance()->info("Parallel shader compilation enabled");
+      }
+    }
+
+
+    bool HasParallelShaderCompile()
+    {
+      static const bool HasExtension = GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+      return HasExtension;
+    }
+    
+
+    Texture::~Texture()
+    {
+      if (isResident()) {
+        TextureResidency::GetInstance().onEvicted(this);
+      }
+      TextureResidency::GetInstance().onDestroyed(this);
+    }
+
+    bool Texture::init(const std::filesystem::path& path)
+    {
+      _path = path;
+      _isInit = load();
+      return _isInit;
+    }
+
+    void Texture::bind(const int unit)
+    {
+      makeResident();
+      StateCache::GetInstance().bindTexture(_handle, unit);
+    }
+
+    bool Texture::makeResident()
+    {
+      if (!_isInit) {
+        return false;
+      }
+      if (isResident()) {
+        TextureResidency::GetInstance().touch(this);
+        return true;
+      }
+      if (!load())
+      {
+        Logger::GetInstance()->error("Cannot reload texture " + _path.string());
+        return false;
+      }
+      return true;
+    }
+
+    void Texture::evict()
+    {
+      if (isResident())
+      {
+        _handle.reset();
+        TextureResidency::GetInstance().onEvicted(this);
+      }
+    }
+
+    bool Texture::load()
+    {
+      // load image
+      stbi_set_flip_vertically_on_load(1);
+      unsigned char* imageData = stbi_load(_path.string().c_str(), &_width, &_height, NULL, 4);
+      if (imageData == nullptr) {
+        stbi_image_free(imageData);
+        _errors.push_back("Cannot load image " + _path.string());
+        return false;
+      }
+
+      // prepare texture
+      _handle = TextureHandle::Create();
+      StateCache::GetInstance().bindTexture(_handle);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+      // load texture
+      glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, _width, _height, 0, GL_RGBA, GL_UNSIGNED_BYTE, imageData);
+      
+      // free resources
+      stbi_image_free(imageData);
+
+      _errors = GetErrors();
+      if (!_errors.empty()) {
+        _handle.reset();
+        return false;
+      }
+
+      TextureResidency::GetInstance().onLoaded(this);
+      return true;
+    }
+
+
+    std::shared_ptr<Texture> FactoryTexture::Create(const std::filesystem::path& path)
+    {
+      auto texture = std::make_shared<Texture>();
+      if (!texture->init(path))
+      {
+        const auto& errors = texture->errors();
+        if (!errors.empty())
+        {
+          std::string errMsg = "Cannot create texture " + path.string() + ':';
+          for (const auto& error : texture->errors()) {
+            errMsg += "\n\t" + error;
+          }
+          Logger::GetInstance()->error(errMsg);
+        }
+      }
+      return texture;
+    }
+
+
+    bool Shader::init(const std::filesystem::path& path, const int type, const ShaderDefines& defines)
+    {
+      std::string text;
+      if (!ShaderPreprocessor::ReadFile(path, text))
+      {
+        helpers::Logger::GetInstance()->error("Cannot open file " + path.string());
+        return false;
+      }
+      return init(text, path, type, defines);
+    }
+
+
+    bool Shader::init(const std::string& text, const std::filesystem::path& path, const int type, const ShaderDefines& defines)
+    {
+      const auto logger = helpers::Logger::GetInstance();
+
+      if (_type != NO_TYPE)
+      {
+        logger->error("Shader is already initialized");
+        return false;
+      }
+
+      // resolve the includes
+      if (!ShaderPreprocessor::Process(text, path, defines, _source, _sourceMap)) {
+        return false;
+      }
+      _text = text;
+      _type = type;
+      _path = path;
+      _defines = defines;
+
+      // the compilation is submitted when building the program
+      return true;
+    }
+     
+
+    bool Shader::compile(const std::string& source, const int type)
+    {
+      if (!compileAsync(source, type)) {
+        return false;
+      }
+
+      // check compilation errors
+      if (!status())
+      {
+        helpers::Logger::GetInstance()->error("Shader compilation failed: " + infoLog());
+        return false;
+      }
+
+      return true;    
+    }
+
+
+    bool Shader::compileAsync(const std::string& source, const int type)
+    {
+      _source = source;
+      _text = source;
+      _sourceMap = ShaderSourceMap{};  // the lines are not mapped anymore
+      _type = type;
+      _isSubmitted = false;
+      return submit();
+    }
+
+
+    bool Shader::submit()
+    {
+      if (_isSubmitted) {
+        return true;
+      }
+      if (_handle == 0)
+      {
+        _handle = ShaderHandle::Create(static_cast<GLenum>(_type));
+        if (_handle == 0)
+        {
+          helpers::Logger::GetInstance()->error("An error occured while creating a the shader");
+          return false;
+        }
+      }
+
+      const auto src = _source.c_str();
+      glShaderSource(_handle, 1, &src, NULL);
+      glCompileShader(_handle);
+      _isSubmitted = true;
+      return true;
+    }
+
+
+    bool Shader::isCompiled() const
+    {
+      if (!_isSubmitted) {
+        return false;
+      }
+      if (!HasParallelShaderCompile()) {
+        return true;  // the status query will block
+      }
+      GLint completed = GL_FALSE;
+      glGetShaderiv(_handle, GL_COMPLETION_STATUS_KHR, &completed);
+      return completed == GL_TRUE;
+    }
+
+
+    bool Shader::status() const
+    {
+      if (!_isSubmitted) {
+        return false;
+      }
+      GLint success = GL_FALSE;
+      glGetShaderiv(_handle, GL_COMPILE_STATUS, &success);
+      return success == GL_TRUE;
+    }
+
+
+    std::string Shader::infoLog() const
+    {
+      return _sourceMap.mapLog(driverLog());
+    }
+
+
+    std::map<int, std::string> Shader::infoLogByLine() const
+    {
+      // the driver numbers the lines of the preprocessed source code
+      return _sourceMap.mapLogByLine(driverLog());
+    }
+
+
+    std::string Shader::driverLog() const
+    {
+      if (!_isSubmitted) {
+        return {};
+      }
+      GLint length = 0;
+      glGetShaderiv(_handle, GL_INFO_LOG_LENGTH, &length);
+      if (length <= 1) {
+        return {};
+      }
+      std::string log(static_cast<std::size_t>(length), '\0');
+      glGetShaderInfoLog(_handle, length, NULL, log.data());
+      log.resize(static_cast<std::size_t>(length) - 1u);  // trailing null character
+      return log;
+    }
+
+
+    bool Shader::dependsOn(const std::filesystem::path& path) const
+    {
+      const auto normalized = path.lexically_normal();
+      if (_sourceMap.files.empty()) {
+        return !_path.empty() && _path.lexically_normal() == normalized;
+      }
+      for (const auto& file : _sourceMap.files)
+      {
+        if (file == normalized) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+
+    std::unordered_map<std::string, std::weak_ptr<Shader>> FactoryShader::_Variants;
+
+
+    std::shared_ptr<Shader> FactoryShader::Create(const std::filesystem::path& path, const int type)
+    {
+      return Create(path, type, {});
+    }
+
+
+    std::shared_ptr<Shader> FactoryShader::Create(const std::filesystem::path& path, const int type, const ShaderDefines& defines)
+    {
+      auto& variant = _Variants[Key(path, type, defines)];
+      auto shader = variant.lock();
+      if (shader == nullptr)
+      {
+        shader = std::make_shared<Shader>();
+        if (shader->init(path, type, defines)) {
+          variant = shader;
+        }
+      }
+      return shader;
+    }
+
+
+    std::shared_ptr<Shader> FactoryShader::Reload(const std::shared_ptr<Shader>& pShader)
+    {
+      auto& variant = _Variants[Key(pShader->path(), pShader->type(), pShader->defines())];
+      auto shader = variant.lock();
+      if (shader != nullptr && shader != pShader) {
+        return shader;  // already reloaded
+      }
+
+      shader = std::make_shared<Shader>();
+      if (!shader->init(pShader->path(), pShader->type(), pShader->defines())) {
+        return nullptr;
+      }
+      variant = shader;
+      return shader;
+    }
+
+
+    std::size_t FactoryShader::NbVariants()
+    {
+      std::size_t nbVariants = 0u;
+      for (auto it = _Variants.begin(); it != _Variants.end(); )
+      {
+        if (it->second.expired()) {
+          it = _Variants.erase(it);
+        }
+        else {
+          ++nbVariants;
+          ++it;
+        }
+      }
+      return nbVariants;
+    }
+
+
+    std::string FactoryShader::Key(const std::filesystem::path& path, const int type, const ShaderDefines& defines)
+    {
+      std::string key = std::to_string(type) + '|' + path.lexically_normal().string();
+      for (const auto& define : defines) {
+        key += '|' + define.first + '=' + define.second;
+      }
+      return key;
+    }
+
+
+
+
+    Program::Program(std::shared_ptr<Shader> pFragShader, std::shared_ptr<Shader> pVertShader, ILogger* pLogger)
+      : _pFragShader{pFragShader}
+      , _pVertShader{pVertShader}
+      , _pLogger{&_loggerDefault}
+    {
+      if (pLogger != nullptr)
+        _pLogger = pLogger;
+    }
+
+
+    bool Program::init()
+    {
+      return createPending(_pFragShader, _pVertShader);
+    }
+
+
+    bool Program::build()
+    {
+      if (!buildAsync()) {
+        return false;
+      }
+      // querying the link status waits for the end of the build
+      GLint success = GL_FALSE;
+      glGetProgramiv(_pending.handle, GL_LINK_STATUS, &success);
+      if (success != GL_TRUE)
+      {
+        logPendingErrors();
+        discardPending();
+        return false;
+      }
+      return poll() == eBuildStatus::SUCCESS;
+    }
+
+
+    bool Program::buildAsync()
+    {
+      if (_pending.handle == 0 && !createPending(_pFragShader, _pVertShader)) {
+        return false;
+      }
+      if (_pending.isLinking) {
+        return true;
+      }
+
+      // a binary produced by a previous run skips the compiler
+      auto& cache = ProgramBinaryCache::GetInstance();
+      _pending.key = cache.key(_pending.pVertShader->source(), _pending.pFragShader->source());
+      if (cache.load(_pending.key, _pending.handle))
+      {
+        _pending.isFromCache = true;
+        _pending.isLinking = true;
+        return true;
+      }
+
+      if (!_pending.pFragShader->submit() || !_pending.pVertShader->submit()) {
+        discardPending();
+        return false;
+      }
+      glAttachShader(_pending.handle, _pending.pFragShader->handle());
+      glAttachShader(_pending.handle, _pending.pVertShader->handle());
+      if (cache.isEnabled()) {
+        glProgramParameteri(_pending.handle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+      }
+      glLinkProgram(_pending.handle);
+      _pending.isLinking = true;
+      return true;
+    }
+
+
+    bool Program::rebuildAsync(std::shared_ptr<Shader> pShader)
+    {
+      const int type = pShader->type();
+      if (type != GL_VERTEX_SHADER && type != GL_FRAGMENT_SHADER)
+      {
+        _pLogger->logError("Type must be GL_VERTEX_SHADER or GL_FRAGMENT_SHADER");
+        return false;
+      }
+
+      // Keep the other shader of the build in progress, if any, so that successive edits are not lost
+      auto pFragShader = _pending.pFragShader ? _pending.pFragShader : _pFragShader;
+      auto pVertShader = _pending.pVertShader ? _pending.pVertShader : _pVertShader;
+      auto& pPrevious = (type == GL_FRAGMENT_SHADER) ? pFragShader : pVertShader;
+
+      if (pShader->path().empty()) {
+        pShader->setPath(pPrevious->path());
+      }
+      pPrevious = std::move(pShader);
+      return rebuildAsync(std::move(pFragShader), std::move(pVertShader));
+    }
+
+
+    bool Program::reloadAsync(const std::filesystem::path& path)
+    {
+      // the latest shaders are the ones being built, if any
+      auto pFragShader = _pending.pFragShader ? _pending.pFragShader : _pFragShader;
+      auto pVertShader = _pending.pVertShader ? _pending.pVertShader : _pVertShader;
+
+      const bool isFragModified = pFragShader->dependsOn(path);
+      const bool isVertModified = pVertShader->dependsOn(path);
+      if (!isFragModified && !isVertModified) {
+        return false;
+      }
+
+      if (isFragModified && (pFragShader = FactoryShader::Reload(pFragShader)) == nullptr) {
+        return false;
+      }
+      if (isVertModified && (pVertShader = FactoryShader::Reload(pVertShader)) == nullptr) {
+        return false;
+      }
+      return rebuildAsync(std::move(pFragShader), std::move(pVertShader));
+    }
+
+
+    bool Program::rebuildAsync(std::shared_ptr<Shader> pFragShader, std::shared_ptr<Shader> pVertShader)
+    {
+      // A newer build supersedes the one in progress
+      discardPending();
+      if (!createPending(std::move(pFragShader), std::move(pVertShader))) {
+        return false;
+      }
+      return buildAsync();
+    }
+
+
+    Program::eBuildStatus Program::poll()
+    {
+      if (_pending.handle == 0 || !_pending.isLinking) {
+        return eBuildStatus::NONE;
+      }
+
+      if (HasParallelShaderCompile())
+      {
+        GLint completed = GL_FALSE;
+        glGetProgramiv(_pending.handle, GL_COMPLETION_STATUS_KHR, &completed);
+        if (completed != GL_TRUE) {
+          return eBuildStatus::PENDING;
+        }
+      }
+
+      GLint success = GL_FALSE;
+      glGetProgramiv(_pending.handle, GL_LINK_STATUS, &success);
+      if (success != GL_TRUE)
+      {
+        logPendingErrors();
+        discardPending();
+        return eBuildStatus::FAILURE;
+      }
+
+      if (!_pending.isFromCache) {
+        ProgramBinaryCache::GetInstance().store(_pending.key, _pending.handle);
+      }
+
+      // swap: the new program is used from now on, the previous one is deleted
+      _handle = std::move(_pending.handle);
+      _pFragShader = std::move(_pending.pFragShader);
+      _pVertShader = std::move(_pending.pVertShader);
+      _pending = Pending{};
+
+      // the locations may differ in the new program
+      introspect();
+      return eBuildStatus::SUCCESS;
+    }
+
+
+    bool Program::createPending(std::shared_ptr<Shader> pFragShader, std::shared_ptr<Shader> pVertShader)
+    {
+      assert(_pending.handle == 0);
+
+      _pending.handle = ProgramHandle::Create();
+      if (_pending.handle == 0)
+      {
+        helpers::Logger::GetInstance()->error("An error occured while creating a the program");
+        return false;
+      }
+      _pending.pFragShader = std::move(pFragShader);
+      _pending.pVertShader = std::move(pVertShader);
+      _pending.isLinking = false;
+      return true;
+    }
+
+
+    void Program::discardPending()
+    {
+      _pending = Pending{};
+    }
+
+
+    void Program::logPendingErrors() const
+    {
+      const auto logger = helpers::Logger::GetInstance();
+      for (const auto& pShader : { _pending.pVertShader, _pending.pFragShader })
+      {
+        if (pShader && !pShader->status()) {
+          logger->error("Shader compilation failed: " + pShader->infoLog());
+        }
+      }
+
+      GLint length = 0;
+      glGetProgramiv(_pending.handle, GL_INFO_LOG_LENGTH, &length);
+      std::string log;
+      if (length > 1)
+      {
+        log.resize(static_cast<std::size_t>(length));
+        glGetProgramInfoLog(_pending.handle, length, NULL, log.data());
+        log.resize(static_cast<std::size_t>(length) - 1u);
+      }
+      logger->error("Program linking failed: " + log);
+    }
+
+    namespace
+    {
+      /// @brief Removes the "[0]" suffix of the arrays
+      std::string ResourceName(std::string name)
+      {
+        const auto pos = name.rfind("[0]");
+        if (pos != std::string::npos && pos + 3u == name.size()) {
+          name.resize(pos);
+        }
+        return name;
+      }
+
+      /// @brief Returns true if a uniform of this type is set with glUniform1i
+      bool IsSetAsInt(const GLenum type)
+      {
+        switch (type)
+        {
+        case GL_INT:
+        case GL_BOOL:
+        case GL_SAMPLER_1D:
+        case GL_SAMPLER_2D:
+        case GL_SAMPLER_3D:
+        case GL_SAMPLER_CUBE:
+        case GL_SAMPLER_2D_SHADOW:
+        case GL_SAMPLER_2D_ARRAY:
+        case GL_SAMPLER_2D_MULTISAMPLE:
+        case GL_SAMPLER_BUFFER:
+        case GL_INT_SAMPLER_2D:
+        case GL_UNSIGNED_INT_SAMPLER_2D:
+          return true;
+        default:
+          return false;
+        }
+      }
+
+      /// @brief Stores the value of a uniform
+      /// @return false if the value did not change since the last upload
+      bool UpdateShadow(ProgramResource& uniform, const void* pValue, const std::size_t size)
+      {
+        assert(size <= sizeof(uniform.shadow));
+        if (uniform.hasShadow && std::memcmp(uniform.shadow.data(), pValue, size) == 0) {
+          return false;
+        }
+        std::memcpy(uniform.shadow.data(), pValue, size);
+        uniform.hasShadow = true;
+        return true;
+      }
+    }
+
+
+    void Program::introspect()
+    {
+      _uniforms.clear();
+      _attributes.clear();
+      _uniformBlocks.clear();
+
+      GLint count = 0;
+      GLint maxLength = 0;
+      std::string name;
+
+      glGetProgramiv(_handle, GL_ACTIVE_UNIFORMS, &count);
+      glGetProgramiv(_handle, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+      name.resize(static_cast<std::size_t>(std::max(maxLength, 1)));
+      for (GLint i = 0; i < count; ++i)
+      {
+        GLsizei length = 0;
+        ProgramResource uniform;
+        glGetActiveUniform(_handle, static_cast<GLuint>(i), maxLength, &length, &uniform.size, &uniform.type, name.data());
+        uniform.name = ResourceName(name.substr(0, static_cast<std::size_t>(length)));
+        uniform.location = glGetUniformLocation(_handle, uniform.name.c_str());
+        if (uniform.location != -1) { // members of the uniform blocks have no location
+          _uniforms.insert(std::move(uniform));
+        }
+      }
+
+      glGetProgramiv(_handle, GL_ACTIVE_ATTRIBUTES, &count);
+      glGetProgramiv(_handle, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+      name.resize(static_cast<std::size_t>(std::max(maxLength, 1)));
+      for (GLint i = 0; i < count; ++i)
+      {
+        GLsizei length = 0;
+        ProgramResource attribute;
+        glGetActiveAttrib(_handle, static_cast<GLuint>(i), maxLength, &length, &attribute.size, &attribute.type, name.data());
+        attribute.name = ResourceName(name.substr(0, static_cast<std::size_t>(length)));
+        attribute.location = glGetAttribLocation(_handle, attribute.name.c_str());
+        if (attribute.location != -1) { // built-in attributes have no location
+          _attributes.insert(std::move(attribute));
+        }
+      }
+
+      glGetProgramiv(_handle, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+      glGetProgramiv(_handle, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength);
+      name.resize(static_cast<std::size_t>(std::max(maxLength, 1)));
+      for (GLint i = 0; i < count; ++i)
+      {
+        GLsizei length = 0;
+        ProgramResource block;
+        glGetActiveUniformBlockName(_handle, static_cast<GLuint>(i), maxLength, &length, name.data());
+        glGetActiveUniformBlockiv(_handle, static_cast<GLuint>(i), GL_UNIFORM_BLOCK_DATA_SIZE, &block.size);
+        block.name = name.substr(0, static_cast<std::size_t>(length));
+        block.location = i;
+        UniformBindings::GetInstance().apply(_handle, block);
+        _uniformBlocks.insert(std::move(block));
+      }
+    }
+
+
+    GLint Program::uniformLocation(std::string_view name) const
+    {
+      const auto pUniform = _uniforms.find(name);
+      return pUniform != nullptr ? pUniform->location : -1;
+    }
+
+
+    GLint Program::attributeLocation(std::string_view name) const
+    {
+      const auto pAttribute = _attributes.find(name);
+      return pAttribute != nullptr ? pAttribute->location : -1;
+    }
+
+
+    GLuint Program::uniformBlockIndex(std::string_view name) const
+    {
+      const auto pBlock = _uniformBlocks.find(name);
+      return pBlock != nullptr ? static_cast<GLuint>(pBlock->location) : GL_INVALID_INDEX;
+    }
+
+
+    ProgramResource* Program::uniform(std::string_view name, const GLenum type)
+    {
+      const auto pUniform = _uniforms.find(name);
+      return (pUniform != nullptr && pUniform->type == type) ? pUniform : nullptr;
+    }
+
+
+    bool Program::setUniform(std::string_view name, const int value)
+    {
+      const auto pUniform = _uniforms.find(name);
+      if (pUniform == nullptr || !IsSetAsInt(pUniform->type)) {
+        return false;
+      }
+      if (UpdateShadow(*pUniform, &value, sizeof(value))) {
+        glUniform1i(pUniform->location, value);
+      }
+      return true;
+    }
+
+
+    bool Program::setUniform(std::string_view name, const float value)
+    {
+      const auto pUniform = uniform(name, GL_FLOAT);
+      if (pUniform == nullptr) {
+        return false;
+      }
+      if (UpdateShadow(*pUniform, &value, sizeof(value))) {
+        glUniform1f(pUniform->location, value);
+      }
+      return true;
+    }
+
+
+    bool Program::setUniform(std::string_view name, const glm::vec2& value)
+    {
+      const auto pUniform = uniform(name, GL_FLOAT_VEC2);
+      if (pUniform == nullptr) {
+        return false;
+      }
+      if (UpdateShadow(*pUniform, &value, sizeof(value))) {
+        glUniform2f(pUniform->location, value.x, value.y);
+      }
+      return true;
+    }
+
+
+    bool Program::setUniform(std::string_view name, const glm::vec3& value)
+    {
+      const auto pUniform = uniform(name, GL_FLOAT_VEC3);
+      if (pUniform == nullptr) {
+        return false;
+      }
+      if (UpdateShadow(*pUniform, &value, sizeof(value))) {
+        glUniform3f(pUniform->location, value.x, value.y, value.z);
+      }
+      return true;
+    }
+
+
+    bool Program::setUniform(std::string_view name, const glm::vec4& value)
+    {
+      const auto pUniform = uniform(name, GL_FLOAT_VEC4);
+      if (pUniform == nullptr) {
+        return false;
+      }
+      if (UpdateShadow(*pUniform, &value, sizeof(value))) {
+        glUniform4f(pUniform->location, value.x, value.y, value.z, value.w);
+      }
+      return true;
+    }
+
+
+    bool Program::setUniform(std::string_view name, const glm::mat4& value)
+    {
+      const auto pUniform = uniform(name, GL_FLOAT_MAT4);
+      if (pUniform == nullptr) {
+        return false;
+      }
+      if (UpdateShadow(*pUniform, &value, sizeof(value))) {
+        glUniformMatrix4fv(pUniform->location, 1, GL_FALSE, &value[0][0]);
+      }
+      return true;
+    }
+
+
+    std::shared_ptr<Shader> Program::shader(const int type)
+    {
+      switch (type)
+      {
+      case GL_VERTEX_SHADER:
+        return _pVertShader;
+        break;
+      case GL_FRAGMENT_SHADER:
+        return _pFragShader;
+        break;
+      default:
+        _pLogger->logError("Type must be GL_VERTEX_SHADER or GL_FRAGMENT_SHADER");
+        _pLogger->logInfo("Returning type GL_FRAGMENT_SHADER by default");
+        return _pFragShader; // Or something invalid?
+        break;
+      }
+    }
+
+
+    std::shared_ptr<Program> FactoryProgram::Create(std::shared_ptr<Shader> pFragShader, std::shared_ptr<Shader> pVertShader)
+    {
+      auto pProgram = std::make_shared<Program>(pFragShader, pVertShader);
+      pProgram->init();
+      return pProgram;
+    }
+
+} // opengl
 } // helpers
\ No newline at end of file
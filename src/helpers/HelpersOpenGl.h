@@ -1,218 +1,459 @@
-//MIT License
-//
-//Copyright(c) 2024
-//Christophe Meneboeuf <christophe@xtof.info>
-//
-//Permission is hereby granted, free of charge, to any person obtaining a copy
-//of this software and associated documentation files(the "Software"), to deal
-//in the Software without restriction, including without limitation the rights
-//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
-//copies of the Software, and to permit persons to whom the Software is
-//furnished to do so, subject to the following conditions :
-//
-//The above copyright notice and this permission notice shall be included in all
-//copies or substantial portions of the Software.
-//
-//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
-//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
-//SOFTWARE.
-
-#pragma once
-
-#include <iostream>
-#include <memory>
-#include <unordered_map>
-#include <filesystem>
-#include <vector>
-#include <string>
-
-#include <GL/glew.h>
-#include <SDL2/SDL.h>
-
-namespace helpers 
-{
-
-  namespace opengl
-  {
-
-    static constexpr int MAJOR_VERSION = 3;
-    static constexpr int MINOR_VERSION = 3;
-
-    static constexpr auto PROFILE = SDL_GLprofile::SDL_GL_CONTEXT_PROFILE_CORE;  // OpenGL core profile - deprecated functions are disabled
-    static constexpr auto GLSL_VERSION = "#version 330 core";
-
-    /// @brief Returns a list of OpenGl errors that occurred since last call
-    std::vector<std::string> GetErrors();
-
-    class ILogger
-    {
-
-    public:
-
-      virtual void logDebug(const std::string& str) = 0;
-      virtual void logInfo(const std::string& str) = 0;
-      virtual void logWarning(const std::string& str) = 0;
-      virtual void logError(const std::string& str) = 0;
-
-    };
-
-    class LoggerDefault : public ILogger
-    {
-
-      virtual void logDebug(const std::string& str) override
-      {
-        std::cout << "[debug]: " << str << std::endl;
-      }
-
-      virtual void logInfo(const std::string& str) override
-      {
-        std::cout << "[logInfo]: " << str << std::endl;
-      }
-
-      virtual void logWarning(const std::string& str) override
-      {
-        std::cout << "[warning]: " << str << std::endl;
-      }
-
-      virtual void logError(const std::string& str) override
-      {
-        std::cout << "[error]: " << str << std::endl;
-      }
-
-    };
-
-    class Texture
-    {
-    public:
-
-      Texture() = default;
-      ~Texture();
-
-      /// @brief Loads initializes an RGBA texture
-      /// @return false if an error occured
-      bool init(const std::filesystem::path& path);
-
-      const std::vector<std::string>& errors() const { return _errors; }
-
-      inline int width() const { return _width;  }
-      inline int height() const { return _height; }
-      inline int handle() const { return _handle; }
-
-      bool isInit() const { return _isInit; }
-
-    private:
-      int _width = 0;
-      int _height = 0;
-      GLuint   _handle = 0u;
-      bool   _isInit = false;
-      std::vector<std::string> _errors;
-    };
-
-
-
-    class FactoryTexture
-    {
-    public:
-
-      /// @brief Instanciates a RGBA texture
-      /// @param path Path of the RGBA texture
-      static std::shared_ptr<Texture> Create(const std::filesystem::path& path);
-
-    };
-
-
-    /// @brief Wrapper around a shader
-  /// @details Useful to free the resources with it's destructor
-    class Shader
-    {
-    public:
-
-      static constexpr int NO_TYPE = -1;
-
-      Shader() = default;
-      Shader(Shader&& rhs) = default;
-
-      inline ~Shader()
-      {
-        glDeleteShader(_handle);
-      }
-
-      Shader operator=(const Shader& rhs) = delete;
-
-      /// @brief Loads and compiles the shader
-      /// @param path Path of the shader's source code
-      /// @param type Type of the shader: **GL_VERTEX_SHADER** or **GL_FRAGMENT_SHADER**
-      bool init(const std::filesystem::path& path, const int type);
-
-      /// @brief Compiles the shader from a textual source code
-      /// @param source Source code
-      /// @param type Type of the shader: **GL_VERTEX_SHADER** or **GL_FRAGMENT_SHADER**
-      bool compile(const std::string& source, const int type);
-
-      /// @brief returns the handle to the compiled shader program
-      inline GLuint handle() const
-      {
-        return _handle;
-      }
-
-    private:
-      GLuint _handle;
-      int _type = NO_TYPE;
-    };
-
-    class FactoryShader
-    {
-    public:
-
-      /// @brief Instanciates either a vertex or a fragment shader
-      /// @param path Path of the shader's source code
-      /// @param type Type of the shader: **GL_VERTEX_SHADER** or **GL_FRAGMENT_SHADER**
-      static std::shared_ptr<Shader> Create(const std::filesystem::path& path, const int type);
-
-    };
-
-
-    class Program
-    {
-    public:
-      Program(std::shared_ptr<Shader> pFragShader, std::shared_ptr<Shader> pVertShader, ILogger* pLogger = nullptr);
-      ~Program();
-
-      bool init();
-      bool build();
-
-      inline GLuint handle() const
-      {
-        return _handle;
-      }
-
-      /// @brief Reurns a shared pointer to one of the shader
-      /// @param type Type of the shader: **GL_VERTEX_SHADER** or **GL_FRAGMENT_SHADER**
-      std::shared_ptr<Shader> shader(const int type);
-
-    private:
-      GLuint _handle = 0;
-      std::shared_ptr<Shader> _pFragShader;
-      std::shared_ptr<Shader> _pVertShader;
-      ILogger* _pLogger;
-      LoggerDefault _loggerDefault;
-    };
-
-
-    class FactoryProgram
-    {
-    public:
-
-      /// @brief Instanciates an OpenGL program
-      static std::shared_ptr<Program> Create(std::shared_ptr<Shader> pFragShader, std::shared_ptr<Shader> pVertShader);
-
-    };
-
-
-  } // opengl
-   
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#pragma once
+
+#include <iostream>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <filesystem>
+#include <vector>
+#include <string>
+#include <string_view>
+
+#include <GL/glew.h>
+#include <SDL2/SDL.h>
+#include <glm/glm.hpp>
+
+#include "GlHandle.h"
+#include "ProgramResources.h"
+#include "ShaderPreprocessor.h"
+
+namespace helpers 
+{
+
+  namespace opengl
+  {
+
+    static constexpr int MAJOR_VERSION = 3;
+    static constexpr int MINOR_VERSION = 3;
+
+    static constexpr auto PROFILE = SDL_GLprofile::SDL_GL_CONTEXT_PROFILE_CORE;  // OpenGL core profile - deprecated functions are disabled
+    static constexpr auto GLSL_VERSION = "#version 330 core";
+
+    /// @brief Returns a list of OpenGl errors that occurred since last call
+    std::vector<std::string> GetErrors();
+
+    /// @brief Lets the driver compile and link the shaders on its own threads
+    /// @details Uses GL_KHR_parallel_shader_compile or GL_ARB_parallel_shader_compile if available
+    void EnableParallelShaderCompile();
+
+    /// @brief Returns true if the driver can report the completion of a compilation without blocking
+    bool HasParallelShaderCompile();
+
+    class ILogger
+    {
+
+    public:
+
+      virtual void logDebug(const std::string& str) = 0;
+      virtual void logInfo(const std::string& str) = 0;
+      virtual void logWarning(const std::string& str) = 0;
+      virtual void logError(const std::string& str) = 0;
+
+    };
+
+    class LoggerDefault : public ILogger
+    {
+
+      virtual void logDebug(const std::string& str) override
+      {
+        std::cout << "[debug]: " << str << std::endl;
+      }
+
+      virtual void logInfo(const std::string& str) override
+      {
+        std::cout << "[logInfo]: " << str << std::endl;
+      }
+
+      virtual void logWarning(const std::string& str) override
+      {
+        std::cout << "[warning]: " << str << std::endl;
+      }
+
+      virtual void logError(const std::string& str) override
+      {
+        std::cout << "[error]: " << str << std::endl;
+      }
+
+    };
+
+    class Texture
+    {
+    public:
+
+      Texture() = default;
+      Texture(const Texture&) = delete;
+      ~Texture();
+
+      Texture& operator=(const Texture&) = delete;
+
+      /// @brief Loads initializes an RGBA texture
+      /// @return false if an error occured
+      bool init(const std::filesystem::path& path);
+
+      /// @brief Binds the texture to a texture unit
+      /// @details Reloads the texture from its file if it was evicted from the video memory
+      void bind(const int unit = 0);
+
+      /// @brief Makes sure the texture is in video memory and marks it as recently used
+      /// @details To be called before using handle() without bind(), ie with ImGui::Image
+      /// @return false if the texture could not be reloaded
+      bool makeResident();
+
+      /// @brief Frees the video memory. The texture stays valid and is reloaded on demand.
+      void evict();
+
+      const std::vector<std::string>& errors() const { return _errors; }
+
+      inline int width() const { return _width;  }
+      inline int height() const { return _height; }
+      /// @brief Returns the OpenGl handle, 0 if the texture is not resident
+      inline GLuint handle() const { return _handle; }
+      inline const std::filesystem::path& path() const { return _path; }
+
+      /// @brief Size occupied in video memory once resident
+      inline std::size_t sizeInBytes() const { return static_cast<std::size_t>(_width) * static_cast<std::size_t>(_height) * 4u; }
+
+      bool isInit() const { return _isInit; }
+      bool isResident() const { return _handle != 0u; }
+
+    private:
+      /// @brief Decodes the file and uploads it in a new OpenGl texture
+      bool load();
+
+      int _width = 0;
+      int _height = 0;
+      TextureHandle _handle;
+      bool   _isInit = false;
+      std::filesystem::path _path;
+      std::vector<std::string> _errors;
+    };
+
+
+
+    class FactoryTexture
+    {
+    public:
+
+      /// @brief Instanciates a RGBA texture
+      /// @param path Path of the RGBA texture
+      static std::shared_ptr<Texture> Create(const std::filesystem::path& path);
+
+    };
+
+
+    /// @brief Wrapper around a shader
+  /// @details Useful to free the resources with it's destructor
+    class Shader
+    {
+    public:
+
+      static constexpr int NO_TYPE = -1;
+
+      Shader() = default;
+      Shader(const Shader&) = delete;
+      Shader(Shader&& rhs) = default;
+
+      Shader& operator=(const Shader&) = delete;
+      Shader& operator=(Shader&& rhs) = default;
+
+      /// @brief Loads and preprocesses the shader's source code
+      /// @details The compilation is submitted when the program is built, and skipped
+      ///          if the program is found in the ProgramBinaryCache.
+      /// @param path Path of the shader's source code
+      /// @param type Type of the shader: **GL_VERTEX_SHADER** or **GL_FRAGMENT_SHADER**
+      /// @param defines Macros injected after the #version directive
+      bool init(const std::filesystem::path& path, const int type, const ShaderDefines& defines = {});
+
+      /// @brief Preprocesses a source code edited in place of the file's
+      /// @details The includes are relative to the path, which is kept: the shader can be reloaded from its file.
+      /// @param text Source code, as written in the file
+      /// @param path Path of the shader's file. Can be empty.
+      bool init(const std::string& text, const std::filesystem::path& path, const int type, const ShaderDefines& defines = {});
+
+      /// @brief Compiles the shader from a textual source code and waits for the result
+      /// @param source Source code
+      /// @param type Type of the shader: **GL_VERTEX_SHADER** or **GL_FRAGMENT_SHADER**
+      bool compile(const std::string& source, const int type);
+
+      /// @brief Submits the compilation of a textual source code without waiting for the result
+      /// @param source Source code
+      /// @param type Type of the shader: **GL_VERTEX_SHADER** or **GL_FRAGMENT_SHADER**
+      bool compileAsync(const std::string& source, const int type);
+
+      /// @brief Submits the compilation of the source code given to init(), if not already done
+      bool submit();
+
+      /// @brief Returns true if the compilation is over. Never blocks.
+      bool isCompiled() const;
+
+      /// @brief Waits for the compilation and returns true if it succeeded
+      bool status() const;
+
+      /// @brief Returns the complete compilation log, with the lines numbers of the original files
+      std::string infoLog() const;
+
+      /// @brief Returns the messages of the compilation log by line of the text of the main file
+      /// @details The messages about the included files are left out. The lines are numbered from 1.
+      std::map<int, std::string> infoLogByLine() const;
+
+      /// @brief returns the handle to the compiled shader program
+      inline GLuint handle() const
+      {
+        return _handle;
+      }
+
+      inline int type() const
+      {
+        return _type;
+      }
+
+      /// @brief Returns the preprocessed source code, available even if the shader is not compiled
+      inline const std::string& source() const
+      {
+        return _source;
+      }
+
+      /// @brief Returns the source code as written in its file, before preprocessing
+      inline const std::string& text() const
+      {
+        return _text;
+      }
+
+      /// @brief Returns the file the source code was loaded from, empty if none
+      inline const std::filesystem::path& path() const
+      {
+        return _path;
+      }
+
+      /// @brief Sets the file the source code comes from, so that the shader is reloaded when it changes
+      inline void setPath(const std::filesystem::path& path)
+      {
+        _path = path;
+      }
+
+      inline const ShaderDefines& defines() const
+      {
+        return _defines;
+      }
+
+      /// @brief Returns the files the source code was made of: the main file and the included ones
+      inline const std::vector<std::filesystem::path>& files() const
+      {
+        return _sourceMap.files;
+      }
+
+      /// @brief Returns true if the source code was made from this file
+      /// @details A source code compiled as is depends on the file it was set from, if any
+      bool dependsOn(const std::filesystem::path& path) const;
+
+    private:
+
+      /// @brief Returns the compilation log, as written by the driver
+      std::string driverLog() const;
+
+      ShaderHandle _handle;
+      int _type = NO_TYPE;
+      std::string _source;
+      std::string _text;
+      std::filesystem::path _path;
+      ShaderDefines _defines;
+      ShaderSourceMap _sourceMap;
+      bool _isSubmitted = false;
+    };
+
+    class FactoryShader
+    {
+    public:
+
+      /// @brief Instanciates either a vertex or a fragment shader
+      /// @param path Path of the shader's source code
+      /// @param type Type of the shader: **GL_VERTEX_SHADER** or **GL_FRAGMENT_SHADER**
+      static std::shared_ptr<Shader> Create(const std::filesystem::path& path, const int type);
+
+      /// @brief Returns the variant of a shader for a set of defines
+      /// @details A variant is instanciated and compiled once, then shared as long as it is in use.
+      ///          Only the variants actually requested are ever compiled.
+      /// @param path Path of the shader's source code
+      /// @param type Type of the shader: **GL_VERTEX_SHADER** or **GL_FRAGMENT_SHADER**
+      /// @param defines Macros injected after the #version directive
+      static std::shared_ptr<Shader> Create(const std::filesystem::path& path, const int type, const ShaderDefines& defines);
+
+      /// @brief Instanciates a new version of a variant whose files were modified
+      /// @details If the variant was already reloaded, for another program, the new version is returned.
+      /// @return nullptr if the variant cannot be loaded
+      static std::shared_ptr<Shader> Reload(const std::shared_ptr<Shader>& pShader);
+
+      /// @brief Returns the number of variants in use
+      static std::size_t NbVariants();
+
+    private:
+
+      static std::string Key(const std::filesystem::path& path, const int type, const ShaderDefines& defines);
+
+      static std::unordered_map<std::string, std::weak_ptr<Shader>> _Variants;
+
+    };
+
+
+    /// @brief Wrapper around a shader program
+    /// @details A program can be rebuilt in the background: the current program stays in use
+    ///          until poll() reports that the new one is successfully linked and swaps them.
+    ///          The active uniforms, attributes and uniform blocks are introspected after each swap,
+    ///          the uniform blocks being bound to the points registered in UniformBindings.
+    class Program
+    {
+    public:
+
+      enum class eBuildStatus
+      {
+        NONE,     ///< No build in progress
+        PENDING,  ///< The driver is still compiling or linking
+        SUCCESS,  ///< The new program is now in use
+        FAILURE   ///< The new program was discarded, the previous one is still in use
+      };
+
+      Program(std::shared_ptr<Shader> pFragShader, std::shared_ptr<Shader> pVertShader, ILogger* pLogger = nullptr);
+      Program(const Program&) = delete;
+
+      Program& operator=(const Program&) = delete;
+
+      bool init();
+
+      /// @brief Links the program and waits for the result
+      bool build();
+
+      /// @brief Submits the link of the program without waiting for the result
+      /// @details The previous program, if any, stays in use until poll() returns eBuildStatus::SUCCESS
+      bool buildAsync();
+
+      /// @brief Links an already compiled shader in a new program, without waiting
+      /// @details The shader replaces the one of the same type, and is not compiled again
+      bool rebuildAsync(std::shared_ptr<Shader> pShader);
+
+      /// @brief Reloads the shaders whose source code comes from this file and links them in a new program, without waiting
+      /// @details The file can be the main file of a shader or one of its includes
+      /// @return false if the file is not used by the program or cannot be read
+      bool reloadAsync(const std::filesystem::path& path);
+
+      /// @brief Checks the build in progress. Never blocks if the driver supports parallel compilation.
+      /// @details On success the new program replaces the current one.
+      eBuildStatus poll();
+
+      /// @brief Returns true if a linked program is available
+      inline bool isReady() const
+      {
+        return _handle != 0;
+      }
+
+      /// @brief Returns true if a build is in progress
+      inline bool isBuilding() const
+      {
+        return _pending.handle != 0;
+      }
+
+      inline GLuint handle() const
+      {
+        return _handle;
+      }
+
+      /// @brief Returns the location of an active uniform, -1 if not active
+      GLint uniformLocation(std::string_view name) const;
+      /// @brief Returns the location of an active attribute, -1 if not active
+      GLint attributeLocation(std::string_view name) const;
+      /// @brief Returns the index of an active uniform block, GL_INVALID_INDEX if not active
+      GLuint uniformBlockIndex(std::string_view name) const;
+
+      inline const ProgramResourceTable& uniforms() const { return _uniforms; }
+      inline const ProgramResourceTable& attributes() const { return _attributes; }
+      inline const ProgramResourceTable& uniformBlocks() const { return _uniformBlocks; }
+
+      /// @brief Sets the value of a uniform. The program must be in use.
+      /// @details Nothing is uploaded if the value did not change since the last call.
+      ///          Arrays of uniforms are set through their first element.
+      /// @return false if the uniform is not active or its type does not match
+      bool setUniform(std::string_view name, const int value);
+      bool setUniform(std::string_view name, const float value);
+      bool setUniform(std::string_view name, const glm::vec2& value);
+      bool setUniform(std::string_view name, const glm::vec3& value);
+      bool setUniform(std::string_view name, const glm::vec4& value);
+      bool setUniform(std::string_view name, const glm::mat4& value);
+
+      /// @brief Reurns a shared pointer to one of the shader
+      /// @param type Type of the shader: **GL_VERTEX_SHADER** or **GL_FRAGMENT_SHADER**
+      std::shared_ptr<Shader> shader(const int type);
+
+    private:
+
+      /// @brief A program being built in the background
+      struct Pending
+      {
+        ProgramHandle handle;
+        std::shared_ptr<Shader> pFragShader;
+        std::shared_ptr<Shader> pVertShader;
+        bool isLinking = false;
+        bool isFromCache = false;   ///< Loaded from the ProgramBinaryCache
+        std::uint64_t key = 0u;     ///< Key in the ProgramBinaryCache
+      };
+
+      /// @brief Links a new program with new shaders, superseding the build in progress
+      bool rebuildAsync(std::shared_ptr<Shader> pFragShader, std::shared_ptr<Shader> pVertShader);
+      /// @brief Creates the pending program
+      bool createPending(std::shared_ptr<Shader> pFragShader, std::shared_ptr<Shader> pVertShader);
+      /// @brief Deletes the pending program
+      void discardPending();
+      /// @brief Logs the link log and the compilation logs of the pending program
+      void logPendingErrors() const;
+      /// @brief Queries the active uniforms, attributes and uniform blocks of the program
+      void introspect();
+      /// @brief Returns the uniform if active and of the given type, nullptr otherwise
+      ProgramResource* uniform(std::string_view name, const GLenum type);
+
+      ProgramHandle _handle;
+      std::shared_ptr<Shader> _pFragShader;
+      std::shared_ptr<Shader> _pVertShader;
+      Pending _pending;
+      ProgramResourceTable _uniforms;
+      ProgramResourceTable _attributes;
+      ProgramResourceTable _uniformBlocks;
+      ILogger* _pLogger;
+      LoggerDefault _loggerDefault;
+    };
+
+
+    class FactoryProgram
+    {
+    public:
+
+      /// @brief Instanciates an OpenGL program
+      static std::shared_ptr<Program> Create(std::shared_ptr<Shader> pFragShader, std::shared_ptr<Shader> pVertShader);
+
+    };
+
+
+  } // opengl
+   
 } // helpers
\ No newline at end of file
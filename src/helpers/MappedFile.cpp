@@ -0,0 +1,152 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifdef _WIN32
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include <utility>
+
+#include "Logger.h"
+#include "MappedFile.h"
+
+
+namespace helpers
+{
+
+  MappedFile::~MappedFile()
+  {
+    close();
+  }
+
+
+  MappedFile::MappedFile(MappedFile&& other) noexcept
+    : _data{ std::exchange(other._data, nullptr) }
+    , _size{ std::exchange(other._size, 0u) }
+  {   }
+
+
+  MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+  {
+    if (this != &other)
+    {
+      close();
+      _data = std::exchange(other._data, nullptr);
+      _size = std::exchange(other._size, 0u);
+    }
+    return *this;
+  }
+
+
+  bool MappedFile::open(const std::filesystem::path& path)
+  {
+    close();
+
+    // the mapping outlives the file handle
+#ifdef _WIN32
+    const HANDLE hFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+      Logger::GetInstance()->error("Cannot open file " + path.string());
+      return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(hFile, &size))
+    {
+      Logger::GetInstance()->error("Cannot get the size of " + path.string());
+      CloseHandle(hFile);
+      return false;
+    }
+    if (size.QuadPart > 0)   // an empty file cannot be mapped
+    {
+      const HANDLE hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      const void* view = hMapping != nullptr ? MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+      if (hMapping != nullptr) {
+        CloseHandle(hMapping);
+      }
+      if (view == nullptr)
+      {
+        Logger::GetInstance()->error("Cannot map file " + path.string());
+        CloseHandle(hFile);
+        return false;
+      }
+      _data = static_cast<const char*>(view);
+      _size = static_cast<std::size_t>(size.QuadPart);
+    }
+    CloseHandle(hFile);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+      Logger::GetInstance()->error("Cannot open file " + path.string());
+      return false;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0)
+    {
+      Logger::GetInstance()->error("Cannot get the size of " + path.string());
+      ::close(fd);
+      return false;
+    }
+    if (status.st_size > 0)   // an empty file cannot be mapped
+    {
+      void* view = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+      if (view == MAP_FAILED)
+      {
+        Logger::GetInstance()->error("Cannot map file " + path.string());
+        ::close(fd);
+        return false;
+      }
+      madvise(view, static_cast<std::size_t>(status.st_size), MADV_SEQUENTIAL);
+      _data = static_cast<const char*>(view);
+      _size = static_cast<std::size_t>(status.st_size);
+    }
+    ::close(fd);
+#endif
+    return true;
+  }
+
+
+  void MappedFile::close()
+  {
+    if (_data != nullptr)
+    {
+#ifdef _WIN32
+      UnmapViewOfFile(_data);
+#else
+      munmap(const_cast<char*>(_data), _size);
+#endif
+    }
+    _data = nullptr;
+    _size = 0u;
+  }
+
+} // helpers
@@ -0,0 +1,120 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "Logger.h"
+#include "Mesh.h"
+#include "StateCache.h"
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    // The layouts of the example
+    static_assert(VertexLayout<Position, UV>::STRIDE == 5u * sizeof(float), "Wrong stride");
+    static_assert(VertexLayout<Position, UV>::OFFSETS[1] == 3u * sizeof(float), "Wrong offset");
+    static_assert(VertexLayout<Position, Color>::OFFSETS[1] == 3u * sizeof(float), "Wrong offset");
+    static_assert(VertexLayout<Position, ColorRGBA8, UV>::OFFSETS[2] == 3u * sizeof(float) + 4u, "Wrong offset");
+
+
+    Mesh::Mesh(Mesh&& rhs) noexcept
+    {
+      *this = std::move(rhs);
+    }
+
+
+    Mesh& Mesh::operator=(Mesh&& rhs) noexcept
+    {
+      if (this != &rhs)
+      {
+        _vao = std::move(rhs._vao);
+        _vbo = std::move(rhs._vbo);
+        _ebo = std::move(rhs._ebo);
+        _nbIndices = std::exchange(rhs._nbIndices, 0);
+        _indexType = rhs._indexType;
+      }
+      return *this;
+    }
+
+
+    void Mesh::draw() const
+    {
+      StateCache::GetInstance().bindVertexArray(_vao);
+      glDrawElements(GL_TRIANGLES, _nbIndices, _indexType, nullptr);
+    }
+
+
+    std::size_t Mesh::upload(const void* vertices, const std::size_t sizeOfVertices, const std::size_t stride,
+                             const std::uint32_t* indices, const std::size_t nbIndices)
+    {
+      if (sizeOfVertices == 0u || sizeOfVertices % stride != 0u)
+      {
+        Logger::GetInstance()->error("The size of the vertex data is not a multiple of the vertex size");
+        return 0u;
+      }
+      const std::size_t nbVertices = sizeOfVertices / stride;
+
+      _vao = VertexArrayHandle::Create();
+      _vbo = BufferHandle::Create();
+      _ebo = BufferHandle::Create();
+      _nbIndices = 0;
+
+      StateCache::GetInstance().bindVertexArray(_vao); // the index buffer is hosted by the vertex array
+      glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+      glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeOfVertices), vertices, GL_STATIC_DRAW);
+
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ebo);
+      if (nbVertices <= std::size_t(std::numeric_limits<std::uint16_t>::max()) + 1u)
+      {
+        // half the memory and bandwidth
+        const std::vector<std::uint16_t> indices16{ indices, indices + nbIndices };
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(nbIndices * sizeof(std::uint16_t)), indices16.data(), GL_STATIC_DRAW);
+        _indexType = GL_UNSIGNED_SHORT;
+      }
+      else
+      {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(nbIndices * sizeof(std::uint32_t)), indices, GL_STATIC_DRAW);
+        _indexType = GL_UNSIGNED_INT;
+      }
+      _nbIndices = static_cast<GLsizei>(nbIndices);
+
+      return nbVertices;
+    }
+
+
+    void Mesh::unbind()
+    {
+      // the vertex array keeps the buffers bound at declaration
+      StateCache::GetInstance().bindVertexArray(0u);
+      glBindBuffer(GL_ARRAY_BUFFER, 0u);
+    }
+
+  } // opengl
+
+} // helpers
@@ -0,0 +1,176 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <GL/glew.h>
+
+#include "GlHandle.h"
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    /// @brief Arrangement of the vertex attributes in the vertex buffer
+    enum class eVertexStorage
+    {
+      INTERLEAVED,  ///< Array of structures: the attributes of a vertex are contiguous
+      SEPARATE      ///< Structure of arrays: all the positions, then all the colors...
+    };
+
+
+    /// @brief Describes a vertex attribute
+    /// @tparam T Type of a component
+    /// @tparam N Number of components
+    /// @tparam GlType OpenGL type of a component
+    /// @tparam Normalized Integer components are normalized to [0, 1] or [-1, 1]
+    template<typename T, GLint N, GLenum GlType, GLboolean Normalized = GL_FALSE>
+    struct Attribute
+    {
+      using Component = T;
+      static constexpr GLint     COMPONENTS = N;
+      static constexpr GLenum    TYPE = GlType;
+      static constexpr GLboolean NORMALIZED = Normalized;
+      static constexpr std::size_t SIZE = sizeof(T) * std::size_t(N);
+    };
+
+    struct Position : Attribute<float, 3, GL_FLOAT> {};
+    struct Normal : Attribute<float, 3, GL_FLOAT> {};
+    struct Color : Attribute<float, 3, GL_FLOAT> {};
+    struct ColorRGBA8 : Attribute<std::uint8_t, 4, GL_UNSIGNED_BYTE, GL_TRUE> {};
+    struct UV : Attribute<float, 2, GL_FLOAT> {};
+
+
+    /// @brief Layout of a vertex, computed at compile time
+    /// @details The attribute #i is bound to the location i of the vertex shader.
+    template<typename... Attributes>
+    struct VertexLayout
+    {
+      static_assert(sizeof...(Attributes) > 0, "A vertex has at least one attribute");
+
+      static constexpr std::size_t NB_ATTRIBUTES = sizeof...(Attributes);
+      /// @brief Size of a vertex
+      static constexpr std::size_t STRIDE = (Attributes::SIZE + ...);
+
+      static constexpr std::array<std::size_t, NB_ATTRIBUTES> SIZES = { Attributes::SIZE... };
+      static constexpr std::array<GLint, NB_ATTRIBUTES>       COMPONENTS = { Attributes::COMPONENTS... };
+      static constexpr std::array<GLenum, NB_ATTRIBUTES>      TYPES = { Attributes::TYPE... };
+      static constexpr std::array<GLboolean, NB_ATTRIBUTES>   NORMALIZED = { Attributes::NORMALIZED... };
+
+      /// @brief Offset of each attribute in an interleaved vertex
+      static constexpr std::array<std::size_t, NB_ATTRIBUTES> OFFSETS = []
+      {
+        std::array<std::size_t, NB_ATTRIBUTES> offsets{};
+        std::size_t offset = 0u;
+        for (std::size_t i = 0u; i < NB_ATTRIBUTES; ++i)
+        {
+          offsets[i] = offset;
+          offset += SIZES[i];
+        }
+        return offsets;
+      }();
+
+      /// @brief Declares the attributes of the bound vertex array, sourced from the bound vertex buffer
+      /// @param storage Arrangement of the attributes in the vertex buffer
+      /// @param nbVertices Number of vertices in the buffer, required for SEPARATE storage
+      static void Declare(const eVertexStorage storage, const std::size_t nbVertices)
+      {
+        for (std::size_t i = 0u; i < NB_ATTRIBUTES; ++i)
+        {
+          const bool isInterleaved = (storage == eVertexStorage::INTERLEAVED);
+          const std::size_t offset = isInterleaved ? OFFSETS[i] : OFFSETS[i] * nbVertices;
+          const GLsizei stride = static_cast<GLsizei>(isInterleaved ? STRIDE : SIZES[i]);
+          glVertexAttribPointer(GLuint(i), COMPONENTS[i], TYPES[i], NORMALIZED[i], stride, reinterpret_cast<const void*>(offset));
+          glEnableVertexAttribArray(GLuint(i));
+        }
+      }
+    };
+
+
+    /// @brief Indexed geometry stored in video memory: a vertex array with its vertex and index buffers
+    class Mesh
+    {
+    public:
+
+      Mesh() = default;
+      Mesh(const Mesh&) = delete;
+      Mesh(Mesh&& rhs) noexcept;
+
+      Mesh& operator=(const Mesh&) = delete;
+      Mesh& operator=(Mesh&& rhs) noexcept;
+
+      /// @brief Uploads the geometry
+      /// @tparam Layout A VertexLayout
+      /// @param vertices Vertex data, arranged according to storage
+      /// @param sizeOfVertices Size of the vertex data in bytes
+      /// @param indices Indices of the triangles' vertices. Stored on 16 bits if possible.
+      /// @param nbIndices Number of indices
+      /// @param storage Arrangement of the attributes in the vertex data
+      /// @return false if an error occured
+      template<typename Layout>
+      bool init(const void* vertices, const std::size_t sizeOfVertices,
+                const std::uint32_t* indices, const std::size_t nbIndices,
+                const eVertexStorage storage = eVertexStorage::INTERLEAVED)
+      {
+        const std::size_t nbVertices = upload(vertices, sizeOfVertices, Layout::STRIDE, indices, nbIndices);
+        if (nbVertices == 0u) {
+          return false;
+        }
+        Layout::Declare(storage, nbVertices);
+        unbind();
+        return true;
+      }
+
+      /// @brief Draws the triangles
+      void draw() const;
+
+      inline GLuint vao() const { return _vao; }
+      inline GLsizei nbIndices() const { return _nbIndices; }
+      /// @brief GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+      inline GLenum indexType() const { return _indexType; }
+
+    private:
+
+      /// @brief Creates the buffers and leaves the vertex array bound
+      /// @return The number of vertices, 0 if an error occured
+      std::size_t upload(const void* vertices, const std::size_t sizeOfVertices, const std::size_t stride,
+                         const std::uint32_t* indices, const std::size_t nbIndices);
+      void unbind();
+
+      VertexArrayHandle _vao;
+      BufferHandle      _vbo;
+      BufferHandle      _ebo;
+      GLsizei _nbIndices = 0;
+      GLenum  _indexType = GL_UNSIGNED_INT;
+    };
+
+  } // opengl
+
+} // helpers
@@ -0,0 +1,194 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+#include "Logger.h"
+#include "ProgramBinaryCache.h"
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    namespace
+    {
+      constexpr std::uint32_t MAGIC = 0x42505247u;  // "GRPB"
+
+      /// @brief Header of a binary file
+      struct Header
+      {
+        std::uint32_t magic;
+        std::uint32_t format;
+        std::uint32_t length;
+      };
+
+      /// @brief 64-bit FNV-1a
+      std::uint64_t Hash(const std::string& str, std::uint64_t hash)
+      {
+        for (const char c : str) {
+          hash ^= static_cast<unsigned char>(c);
+          hash *= 0x100000001b3ull;
+        }
+        // separator, so that ("ab","c") and ("a","bc") differ
+        hash ^= 0xffu;
+        hash *= 0x100000001b3ull;
+        return hash;
+      }
+
+      std::string GetString(const GLenum name)
+      {
+        const auto str = glGetString(name);
+        return str != nullptr ? std::string{ reinterpret_cast<const char*>(str) } : std::string{};
+      }
+    }
+
+
+    ProgramBinaryCache ProgramBinaryCache::_Instance;
+
+
+    bool ProgramBinaryCache::setDirectory(const std::filesystem::path& directory)
+    {
+      const auto logger = Logger::GetInstance();
+      _isEnabled = false;
+      _directory = directory;
+
+      GLint nbFormats = 0;
+      if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary) {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &nbFormats);
+      }
+      if (nbFormats <= 0)
+      {
+        logger->info("Program binaries are not supported by the driver");
+        return false;
+      }
+
+      std::error_code error;
+      std::filesystem::create_directories(_directory, error);
+      if (error)
+      {
+        logger->error("Cannot create directory " + _directory.string() + ": " + error.message());
+        return false;
+      }
+
+      _driver = GetString(GL_VENDOR) + '|' + GetString(GL_RENDERER) + '|' + GetString(GL_VERSION);
+      _isEnabled = true;
+      return true;
+    }
+
+
+    ProgramBinaryCache::Key ProgramBinaryCache::key(const std::string& srcVertex, const std::string& srcFragment) const
+    {
+      std::uint64_t hash = 0xcbf29ce484222325ull;
+      hash = Hash(_driver, hash);
+      hash = Hash(srcVertex, hash);
+      hash = Hash(srcFragment, hash);
+      return hash;
+    }
+
+
+    bool ProgramBinaryCache::load(const Key key, const GLuint program)
+    {
+      if (!_isEnabled) {
+        return false;
+      }
+
+      std::ifstream stream{ pathOf(key), std::ios::in | std::ios::binary | std::ios::ate };
+      const auto size = static_cast<std::streamoff>(stream.tellg());
+      stream.seekg(0);
+      Header header{};
+      // a truncated or corrupted file is a miss, its length is not trusted
+      if (!stream.good() || !stream.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != MAGIC
+          || static_cast<std::streamoff>(header.length) != size - static_cast<std::streamoff>(sizeof(header)))
+      {
+        ++_nbMisses;
+        return false;
+      }
+      std::vector<char> binary(header.length);
+      if (!stream.read(binary.data(), static_cast<std::streamsize>(binary.size())))
+      {
+        ++_nbMisses;
+        return false;
+      }
+
+      glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+      GLint success = GL_FALSE;
+      glGetProgramiv(program, GL_LINK_STATUS, &success);
+      if (success != GL_TRUE)
+      {
+        // the driver was updated in place or the file is corrupted: it will be overwritten
+        ++_nbMisses;
+        return false;
+      }
+
+      ++_nbHits;
+      return true;
+    }
+
+
+    bool ProgramBinaryCache::store(const Key key, const GLuint program)
+    {
+      if (!_isEnabled) {
+        return false;
+      }
+
+      GLint length = 0;
+      glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+      if (length <= 0) {
+        return false;
+      }
+      std::vector<char> binary(static_cast<std::size_t>(length));
+      GLenum format = 0;
+      glGetProgramBinary(program, length, &length, &format, binary.data());
+
+      const auto path = pathOf(key);
+      std::ofstream stream{ path, std::ios::out | std::ios::binary | std::ios::trunc };
+      const Header header{ MAGIC, static_cast<std::uint32_t>(format), static_cast<std::uint32_t>(length) };
+      stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      stream.write(binary.data(), length);
+      if (!stream.good())
+      {
+        Logger::GetInstance()->error("Cannot write program binary " + path.string());
+        return false;
+      }
+      return true;
+    }
+
+
+    std::filesystem::path ProgramBinaryCache::pathOf(const Key key) const
+    {
+      static constexpr char Digits[] = "0123456789abcdef";
+      std::string name(16u, '0');
+      for (int i = 15; i >= 0; --i) {
+        name[static_cast<std::size_t>(i)] = Digits[(key >> ((15 - i) * 4)) & 0xfu];
+      }
+      return _directory / (name + ".bin");
+    }
+
+  } // opengl
+
+} // helpers
@@ -0,0 +1,92 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#include <GL/glew.h>
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    /// @brief Persists the linked programs on disk
+    /// @details A binary is retrieved with glGetProgramBinary once a program is linked and reloaded
+    ///          with glProgramBinary on next launch, skipping the compiler entirely.
+    ///          The key of a binary is a hash of the sources and of the driver's vendor, renderer and version:
+    ///          a binary produced by another driver is never loaded.
+    class ProgramBinaryCache
+    {
+    public:
+
+      using Key = std::uint64_t;
+
+      static ProgramBinaryCache& GetInstance() {
+        return _Instance;
+      }
+
+      /// @brief Sets the directory where the binaries are stored and creates it if needed
+      /// @details The cache is disabled until a directory is set. Must be called with a valid OpenGL context.
+      bool setDirectory(const std::filesystem::path& directory);
+      inline const std::filesystem::path& directory() const { return _directory; }
+
+      /// @brief Returns true if the driver supports binaries and a directory is set
+      inline bool isEnabled() const { return _isEnabled; }
+
+      /// @brief Computes the key of a program from the sources of its shaders
+      Key key(const std::string& srcVertex, const std::string& srcFragment) const;
+
+      /// @brief Loads a binary into a program
+      /// @return false if there is no binary for this key or if the driver rejected it.
+      ///         The program can then be linked from its sources.
+      bool load(const Key key, const GLuint program);
+
+      /// @brief Retrieves the binary of a successfully linked program and writes it on disk
+      bool store(const Key key, const GLuint program);
+
+      inline std::uint64_t nbHits() const { return _nbHits; }
+      inline std::uint64_t nbMisses() const { return _nbMisses; }
+
+    private:
+
+      std::filesystem::path pathOf(const Key key) const;
+
+      static ProgramBinaryCache _Instance;
+
+      std::filesystem::path _directory;
+      std::string _driver;  ///< Vendor, renderer and version of the driver
+      bool _isEnabled = false;
+
+      std::uint64_t _nbHits = 0u;
+      std::uint64_t _nbMisses = 0u;
+    };
+
+  } // opengl
+
+} // helpers
@@ -0,0 +1,119 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "ProgramResources.h"
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    void ProgramResourceTable::clear()
+    {
+      _resources.clear();
+      _slots.clear();
+    }
+
+
+    void ProgramResourceTable::insert(ProgramResource resource)
+    {
+      if ((_resources.size() + 1u) * 2u > _slots.size()) {
+        grow();
+      }
+
+      const auto hash = Hash(resource.name);
+      auto& slot = _slots[probe(resource.name, hash)];
+      if (slot.index != EMPTY) {
+        _resources[slot.index - 1u] = std::move(resource);
+        return;
+      }
+      _resources.push_back(std::move(resource));
+      slot.hash = hash;
+      slot.index = static_cast<std::uint32_t>(_resources.size());
+    }
+
+
+    const ProgramResource* ProgramResourceTable::find(std::string_view name) const
+    {
+      if (_slots.empty()) {
+        return nullptr;
+      }
+      const auto& slot = _slots[probe(name, Hash(name))];
+      return slot.index != EMPTY ? &_resources[slot.index - 1u] : nullptr;
+    }
+
+
+    ProgramResource* ProgramResourceTable::find(std::string_view name)
+    {
+      return const_cast<ProgramResource*>(static_cast<const ProgramResourceTable*>(this)->find(name));
+    }
+
+
+    std::uint32_t ProgramResourceTable::Hash(std::string_view name)
+    {
+      // 32-bit FNV-1a
+      std::uint32_t hash = 0x811c9dc5u;
+      for (const char c : name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x01000193u;
+      }
+      return hash;
+    }
+
+
+    std::size_t ProgramResourceTable::probe(std::string_view name, const std::uint32_t hash) const
+    {
+      const std::size_t mask = _slots.size() - 1u;
+      std::size_t i = hash & mask;
+      while (_slots[i].index != EMPTY)
+      {
+        if (_slots[i].hash == hash && _resources[_slots[i].index - 1u].name == name) {
+          break;
+        }
+        i = (i + 1u) & mask;
+      }
+      return i;
+    }
+
+
+    void ProgramResourceTable::grow()
+    {
+      const std::size_t capacity = _slots.empty() ? 16u : _slots.size() * 2u;
+      _slots.assign(capacity, Slot{});
+      const std::size_t mask = capacity - 1u;
+      for (std::uint32_t index = 0u; index < _resources.size(); ++index)
+      {
+        const auto hash = Hash(_resources[index].name);
+        std::size_t i = hash & mask;
+        while (_slots[i].index != EMPTY) {
+          i = (i + 1u) & mask;
+        }
+        _slots[i] = Slot{ hash, index + 1u };
+      }
+    }
+
+  } // opengl
+
+} // helpers
@@ -0,0 +1,99 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <GL/glew.h>
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    /// @brief An active uniform, attribute or uniform block of a program
+    struct ProgramResource
+    {
+      std::string name;
+      GLint  location = -1;  ///< Location, or index of a uniform block
+      GLenum type = 0;       ///< 0 for a uniform block
+      GLint  size = 0;       ///< Number of elements of an array, data size in bytes of a uniform block
+
+      /// @brief Last value uploaded to a uniform, to skip the redundant uploads
+      std::array<std::uint32_t, 16> shadow{};
+      bool hasShadow = false;
+    };
+
+
+    /// @brief Flat hash table of the resources of a program, looked up by name
+    /// @details Open addressing with linear probing. The resources are stored contiguously,
+    ///          the slots only hold the hash of the names and the indices of the resources.
+    class ProgramResourceTable
+    {
+    public:
+
+      void clear();
+
+      /// @brief Inserts a resource. A resource with the same name is replaced.
+      void insert(ProgramResource resource);
+
+      /// @brief Returns nullptr if the resource is not active
+      const ProgramResource* find(std::string_view name) const;
+      ProgramResource* find(std::string_view name);
+
+      inline std::size_t size() const { return _resources.size(); }
+      inline bool empty() const { return _resources.empty(); }
+
+      inline std::vector<ProgramResource>::const_iterator begin() const { return _resources.cbegin(); }
+      inline std::vector<ProgramResource>::const_iterator end() const { return _resources.cend(); }
+
+    private:
+
+      static constexpr std::uint32_t EMPTY = 0u;
+
+      struct Slot
+      {
+        std::uint32_t hash = 0u;
+        std::uint32_t index = EMPTY;  ///< Index of the resource + 1, EMPTY if the slot is free
+      };
+
+      static std::uint32_t Hash(std::string_view name);
+
+      /// @brief Returns the slot holding name, or the free slot where it would be inserted
+      std::size_t probe(std::string_view name, const std::uint32_t hash) const;
+      void grow();
+
+      std::vector<ProgramResource> _resources;
+      std::vector<Slot> _slots;  ///< Size is a power of two, at most half full
+    };
+
+  } // opengl
+
+} // helpers
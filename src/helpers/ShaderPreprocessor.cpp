@@ -0,0 +1,283 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <cstring>
+#include <fstream>
+#include <regex>
+#include <sstream>
+
+#include "Logger.h"
+#include "ShaderPreprocessor.h"
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    namespace
+    {
+
+      /// @brief Returns true if line is the directive, ignoring the leading blanks
+      bool IsDirective(const std::string& line, const char* directive, std::size_t& end)
+      {
+        const auto begin = line.find_first_not_of(" \t");
+        if (begin == std::string::npos || line.compare(begin, std::strlen(directive), directive) != 0) {
+          return false;
+        }
+        end = begin + std::strlen(directive);
+        return end == line.size() || line[end] == ' ' || line[end] == '\t' || line[end] == '"' || line[end] == '<';
+      }
+
+      /// @brief State of a preprocessing
+      class Context
+      {
+      public:
+
+        Context(const ShaderDefines& defines, std::string& source, ShaderSourceMap& map)
+          : _defines{ defines }, _source{ source }, _map{ map }
+        {
+          _source.clear();
+          _map.files.clear();
+          _map.lines.clear();
+        }
+
+        bool append(const std::string& input, const std::filesystem::path& path, const int depth)
+        {
+          const auto file = static_cast<std::uint32_t>(_map.files.size());
+          _map.files.push_back(path);
+
+          std::istringstream stream{ input };
+          std::string line;
+          std::uint32_t numLine = 0u;
+          std::size_t end = 0u;
+
+          // The defines go after #version, which must come first
+          const bool isMain = (depth == 0);
+          bool isDefinesPending = isMain && !_defines.empty();
+          if (isDefinesPending && input.find("#version") == std::string::npos) {
+            appendDefines(file, 1u);
+            isDefinesPending = false;
+          }
+
+          while (std::getline(stream, line))
+          {
+            ++numLine;
+            if (!line.empty() && line.back() == '\r') {
+              line.pop_back();
+            }
+
+            if (IsDirective(line, "#version", end))
+            {
+              if (isMain) {
+                appendLine(line, file, numLine);
+              }
+              if (isDefinesPending) {
+                appendDefines(file, numLine);
+                isDefinesPending = false;
+              }
+            }
+            else if (IsDirective(line, "#include", end))
+            {
+              if (!include(line.substr(end), path, numLine, depth)) {
+                return false;
+              }
+            }
+            else {
+              appendLine(line, file, numLine);
+            }
+          }
+          return true;
+        }
+
+      private:
+
+        bool include(const std::string& argument, const std::filesystem::path& pathIncluding, const std::uint32_t numLine, const int depth)
+        {
+          const auto logger = Logger::GetInstance();
+          const auto where = pathIncluding.string() + ':' + std::to_string(numLine) + ": ";
+
+          const auto begin = argument.find_first_of("\"<");
+          const auto end = (begin == std::string::npos) ? std::string::npos : argument.find_first_of("\">", begin + 1u);
+          if (end == std::string::npos)
+          {
+            logger->error(where + "malformed #include");
+            return false;
+          }
+          if (depth + 1 > ShaderPreprocessor::MAX_INCLUDE_DEPTH)
+          {
+            logger->error(where + "too many nested #include");
+            return false;
+          }
+
+          const auto path = (pathIncluding.parent_path() / argument.substr(begin + 1u, end - begin - 1u)).lexically_normal();
+          for (const auto& included : _map.files)
+          {
+            if (included == path) {
+              return true;  // already included
+            }
+          }
+
+          std::string content;
+          if (!ShaderPreprocessor::ReadFile(path, content))
+          {
+            logger->error(where + "cannot open " + path.string());
+            return false;
+          }
+          return append(content, path, depth + 1);
+        }
+
+        void appendDefines(const std::uint32_t file, const std::uint32_t numLine)
+        {
+          for (const auto& define : _defines) {
+            appendLine("#define " + define.first + ' ' + define.second, file, numLine);
+          }
+        }
+
+        void appendLine(const std::string& line, const std::uint32_t file, const std::uint32_t numLine)
+        {
+          _source += line;
+          _source += '\n';
+          _map.lines.push_back({ file, numLine });
+        }
+
+        const ShaderDefines& _defines;
+        std::string& _source;
+        ShaderSourceMap& _map;
+      };
+
+    }
+
+
+    std::string ShaderSourceMap::mapLog(const std::string& log) const
+    {
+      if (lines.empty()) {
+        return log;
+      }
+
+      std::string mapped;
+      for (const auto& line : ParseLog(log))
+      {
+        mapped += mapLine(line);
+        mapped += '\n';
+      }
+      return mapped;
+    }
+
+
+    std::map<int, std::string> ShaderSourceMap::mapLogByLine(const std::string& log) const
+    {
+      std::map<int, std::string> messages;
+      for (const auto& line : ParseLog(log))
+      {
+        if (line.numLine == 0u) {
+          continue;
+        }
+        auto numLine = line.numLine;
+        if (!lines.empty())
+        {
+          // only the lines of the main file
+          if (numLine > lines.size() || lines[numLine - 1u].file != 0u) {
+            continue;
+          }
+          numLine = lines[numLine - 1u].line;
+        }
+        auto& messagesLine = messages[static_cast<int>(numLine)];
+        if (!messagesLine.empty()) {
+          messagesLine += '\n';
+        }
+        messagesLine += mapLine(line);
+      }
+      return messages;
+    }
+
+
+    std::vector<ShaderSourceMap::LogLine> ShaderSourceMap::ParseLog(const std::string& log)
+    {
+      // <source string>:<line> or <source string>(<line>)
+      static const std::regex Location{ R"((\d+)(?::(\d+)|\((\d+)\)))" };
+
+      std::vector<LogLine> parsed;
+      std::istringstream stream{ log };
+      std::string line;
+      std::smatch match;
+      while (std::getline(stream, line))
+      {
+        LogLine logLine;
+        if (std::regex_search(line, match, Location))
+        {
+          logLine.numLine = static_cast<std::uint32_t>(std::stoul(match[2].matched ? match[2].str() : match[3].str()));
+          logLine.locationBegin = static_cast<std::size_t>(match.position(0));
+          logLine.locationEnd = logLine.locationBegin + static_cast<std::size_t>(match.length(0));
+        }
+        logLine.text = std::move(line);
+        parsed.push_back(std::move(logLine));
+      }
+      return parsed;
+    }
+
+
+    std::string ShaderSourceMap::mapLine(const LogLine& line) const
+    {
+      if (line.numLine < 1u || line.numLine > lines.size()) {
+        return line.text;
+      }
+      const auto& origin = lines[line.numLine - 1u];
+      return line.text.substr(0u, line.locationBegin) + files[origin.file].filename().string() + ':' + std::to_string(origin.line)
+        + line.text.substr(line.locationEnd);
+    }
+
+
+    bool ShaderPreprocessor::ReadFile(const std::filesystem::path& path, std::string& content)
+    {
+      std::ifstream stream{ path };
+      if (!stream.good()) {
+        return false;
+      }
+      content.assign(std::istreambuf_iterator<char>{stream}, {});
+      return true;
+    }
+
+
+    bool ShaderPreprocessor::Process(const std::filesystem::path& path, const ShaderDefines& defines, std::string& source, ShaderSourceMap& map)
+    {
+      std::string input;
+      if (!ReadFile(path, input))
+      {
+        Logger::GetInstance()->error("Cannot open file " + path.string());
+        return false;
+      }
+      return Process(input, path, defines, source, map);
+    }
+
+
+    bool ShaderPreprocessor::Process(const std::string& input, const std::filesystem::path& path, const ShaderDefines& defines, std::string& source, ShaderSourceMap& map)
+    {
+      Context context{ defines, source, map };
+      return context.append(input, path.lexically_normal(), 0);
+    }
+
+  } // opengl
+
+} // helpers
@@ -0,0 +1,112 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    /// @brief Macros injected in a shader: name -> value
+    /// @details Ordered, so that a set of defines always produces the same source code
+    using ShaderDefines = std::map<std::string, std::string>;
+
+
+    /// @brief Maps the lines of a preprocessed source code to their original files
+    struct ShaderSourceMap
+    {
+      struct Location
+      {
+        std::uint32_t file;  ///< Index in files
+        std::uint32_t line;  ///< Starting at 1
+      };
+
+      std::vector<std::filesystem::path> files;  ///< The main file first, then the included files
+      std::vector<Location> lines;               ///< Origin of each line of the preprocessed source code
+
+      /// @brief A line of a compilation log
+      struct LogLine
+      {
+        std::string text;
+        std::uint32_t numLine = 0u;     ///< Line of the source code it is about, 0 if none
+        std::size_t locationBegin = 0u; ///< Position of the location in the text
+        std::size_t locationEnd = 0u;
+      };
+
+      /// @brief Rewrites the line numbers of a compilation log as "file:line"
+      std::string mapLog(const std::string& log) const;
+
+      /// @brief Returns the messages of a compilation log by line of the main file, rewritten as by mapLog()
+      /// @details The messages about the included files are left out. The lines are numbered from 1.
+      std::map<int, std::string> mapLogByLine(const std::string& log) const;
+
+      /// @brief Splits a compilation log in lines, and finds the line of the source code each one is about
+      /// @details Understands the "0:12", "0(12)" and "ERROR: 0:12" formats of the major drivers
+      static std::vector<LogLine> ParseLog(const std::string& log);
+
+    private:
+
+      std::string mapLine(const LogLine& line) const;
+    };
+
+
+    /// @brief Preprocessing stage applied before the compilation of a shader
+    /// @details * `#include "file"` is replaced by the content of file, relative to the including file.
+    ///            A file is included only once.
+    ///          * The defines are injected right after the `#version` directive.
+    class ShaderPreprocessor
+    {
+    public:
+
+      static constexpr int MAX_INCLUDE_DEPTH = 32;
+
+      /// @brief Preprocesses a shader file
+      /// @param path Path of the shader
+      /// @param defines Macros to inject
+      /// @param source Receives the preprocessed source code
+      /// @param map Receives the origin of each line
+      /// @return false if a file cannot be read. The error is logged.
+      static bool Process(const std::filesystem::path& path, const ShaderDefines& defines, std::string& source, ShaderSourceMap& map);
+
+      /// @brief Preprocesses a source code
+      /// @param path Path the source code comes from. The includes are relative to it. Can be empty.
+      static bool Process(const std::string& input, const std::filesystem::path& path, const ShaderDefines& defines, std::string& source, ShaderSourceMap& map);
+
+      /// @brief Reads a whole text file
+      /// @return false if the file cannot be read. The error is not logged.
+      static bool ReadFile(const std::filesystem::path& path, std::string& content);
+
+    };
+
+  } // opengl
+
+} // helpers
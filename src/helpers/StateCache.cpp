@@ -0,0 +1,187 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <cassert>
+#include <limits>
+
+#include "StateCache.h"
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    StateCache StateCache::_Instance;
+
+
+    StateCache::StateCache()
+    {
+      invalidate();
+    }
+
+
+    void StateCache::useProgram(const GLuint program)
+    {
+      if (update(_program, program)) {
+        glUseProgram(program);
+      }
+    }
+
+
+    void StateCache::bindVertexArray(const GLuint vao)
+    {
+      if (update(_vao, vao)) {
+        glBindVertexArray(vao);
+      }
+    }
+
+
+    void StateCache::bindTexture(const GLuint texture, const int unit)
+    {
+      assert(unit >= 0 && unit < MAX_TEXTURE_UNITS);
+      if (_textures[unit] == texture)
+      {
+        ++_nbAvoided;
+        return;
+      }
+      activeTexture(unit);
+      update(_textures[unit], texture);
+      glBindTexture(GL_TEXTURE_2D, texture);
+    }
+
+
+    void StateCache::bindTexture(const GLuint texture)
+    {
+      bindTexture(texture, _activeUnit >= 0 ? _activeUnit : 0);
+    }
+
+
+    void StateCache::bindFramebuffer(const GLuint fbo)
+    {
+      if (update(_fbo, fbo)) {
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+      }
+    }
+
+
+    void StateCache::bindRenderbuffer(const GLuint rbo)
+    {
+      if (update(_rbo, rbo)) {
+        glBindRenderbuffer(GL_RENDERBUFFER, rbo);
+      }
+    }
+
+
+    void StateCache::viewport(const GLint x, const GLint y, const GLsizei width, const GLsizei height)
+    {
+      if (update(_viewport, { x, y, width, height })) {
+        glViewport(x, y, width, height);
+      }
+    }
+
+
+    void StateCache::clearColor(const float r, const float g, const float b, const float a)
+    {
+      if (update(_clearColor, { r, g, b, a })) {
+        glClearColor(r, g, b, a);
+      }
+    }
+
+
+    void StateCache::forgetProgram(const GLuint program)
+    {
+      if (_program == program) {
+        _program = UNKNOWN;
+      }
+    }
+
+
+    void StateCache::forgetVertexArray(const GLuint vao)
+    {
+      if (_vao == vao) {
+        _vao = UNKNOWN;
+      }
+    }
+
+
+    void StateCache::forgetTexture(const GLuint texture)
+    {
+      for (auto& bound : _textures)
+      {
+        if (bound == texture) {
+          bound = UNKNOWN;
+        }
+      }
+    }
+
+
+    void StateCache::forgetFramebuffer(const GLuint fbo)
+    {
+      if (_fbo == fbo) {
+        _fbo = UNKNOWN;
+      }
+    }
+
+
+    void StateCache::forgetRenderbuffer(const GLuint rbo)
+    {
+      if (_rbo == rbo) {
+        _rbo = UNKNOWN;
+      }
+    }
+
+
+    void StateCache::invalidate()
+    {
+      _program = UNKNOWN;
+      _vao = UNKNOWN;
+      _fbo = UNKNOWN;
+      _rbo = UNKNOWN;
+      _activeUnit = -1;
+      _textures.fill(UNKNOWN);
+      _viewport.fill(-1);
+      _clearColor.fill(std::numeric_limits<float>::quiet_NaN()); // never equal
+    }
+
+
+    void StateCache::newFrame()
+    {
+      _nbCallsLastFrame = _nbCalls;
+      _nbAvoidedLastFrame = _nbAvoided;
+      _nbCalls = 0u;
+      _nbAvoided = 0u;
+    }
+
+
+    void StateCache::activeTexture(const int unit)
+    {
+      if (update(_activeUnit, unit)) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+      }
+    }
+
+  } // opengl
+
+} // helpers
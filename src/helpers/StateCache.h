@@ -0,0 +1,123 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <GL/glew.h>
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    /// @brief Shadows the OpenGL state to skip the redundant driver calls
+    /// @details The state is only known once set through the cache: any code changing it with
+    ///          direct OpenGL calls must call invalidate() afterwards. Code restoring the state
+    ///          it changed, such as the ImGui backend, does not need to.
+    ///          Deleted objects must be forgotten: OpenGL unbinds them and may reuse their names.
+    class StateCache
+    {
+    public:
+
+      static constexpr int MAX_TEXTURE_UNITS = 32;
+
+      static StateCache& GetInstance() {
+        return _Instance;
+      }
+
+      void useProgram(const GLuint program);
+      void bindVertexArray(const GLuint vao);
+      /// @brief Binds a 2D texture to a texture unit, which becomes the active one
+      void bindTexture(const GLuint texture, const int unit);
+      /// @brief Binds a 2D texture to the active unit, to modify it
+      void bindTexture(const GLuint texture);
+      void bindFramebuffer(const GLuint fbo);
+      void bindRenderbuffer(const GLuint rbo);
+      void viewport(const GLint x, const GLint y, const GLsizei width, const GLsizei height);
+      void clearColor(const float r, const float g, const float b, const float a);
+
+      /// @brief Called before deleting an object
+      void forgetProgram(const GLuint program);
+      void forgetVertexArray(const GLuint vao);
+      void forgetTexture(const GLuint texture);
+      void forgetFramebuffer(const GLuint fbo);
+      void forgetRenderbuffer(const GLuint rbo);
+
+      /// @brief The state was changed by direct OpenGL calls: the next calls will reach the driver
+      void invalidate();
+
+      /// @brief Starts counting the calls of a new frame
+      void newFrame();
+
+      /// @brief Number of calls forwarded to the driver during the last frame
+      inline std::uint32_t nbCalls() const { return _nbCallsLastFrame; }
+      /// @brief Number of redundant calls skipped during the last frame
+      inline std::uint32_t nbAvoided() const { return _nbAvoidedLastFrame; }
+
+    private:
+
+      static constexpr GLuint UNKNOWN = ~0u;
+
+      /// @brief Returns true if the call must reach the driver. Counts the calls.
+      template<typename T>
+      bool update(T& shadow, const T& value)
+      {
+        if (shadow == value)
+        {
+          ++_nbAvoided;
+          return false;
+        }
+        shadow = value;
+        ++_nbCalls;
+        return true;
+      }
+
+      void activeTexture(const int unit);
+
+      static StateCache _Instance;
+
+      GLuint _program = UNKNOWN;
+      GLuint _vao = UNKNOWN;
+      GLuint _fbo = UNKNOWN;
+      GLuint _rbo = UNKNOWN;
+      int    _activeUnit = -1;
+      std::array<GLuint, MAX_TEXTURE_UNITS> _textures;
+      std::array<GLint, 4> _viewport;
+      std::array<float, 4> _clearColor;
+
+      std::uint32_t _nbCalls = 0u;
+      std::uint32_t _nbAvoided = 0u;
+      std::uint32_t _nbCallsLastFrame = 0u;
+      std::uint32_t _nbAvoidedLastFrame = 0u;
+
+      StateCache();
+    };
+
+  } // opengl
+
+} // helpers
@@ -0,0 +1,198 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <algorithm>
+
+#include "Logger.h"
+#include "StreamBuffer.h"
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    StreamBuffer::~StreamBuffer()
+    {
+      release();
+    }
+
+
+    bool StreamBuffer::init(const GLenum target, const std::size_t sizePerFrame)
+    {
+      release();
+      _target = target;
+      _region = 0;
+      _used = 0u;
+
+      _alignment = 16u;
+      if (target == GL_UNIFORM_BUFFER)
+      {
+        GLint alignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        _alignment = std::max<std::size_t>(_alignment, static_cast<std::size_t>(alignment));
+      }
+      _sizePerFrame = (sizePerFrame + _alignment - 1u) / _alignment * _alignment;
+
+      // bound to a neutral target: binding an index buffer would modify the bound vertex array
+      _handle = BufferHandle::Create();
+      glBindBuffer(GL_COPY_WRITE_BUFFER, _handle);
+      const bool hasStorage = GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+      if (hasStorage)
+      {
+        static constexpr GLbitfield Flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        const auto size = static_cast<GLsizeiptr>(_sizePerFrame * NB_REGIONS);
+        glBufferStorage(GL_COPY_WRITE_BUFFER, size, nullptr, Flags);
+        _pMapped = static_cast<unsigned char*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, Flags));
+      }
+      if (_pMapped == nullptr)
+      {
+        if (hasStorage)
+        {
+          // the storage given to the buffer is immutable: glBufferData requires a new buffer
+          _handle = BufferHandle::Create();
+          glBindBuffer(GL_COPY_WRITE_BUFFER, _handle);
+        }
+        // orphaning: each upload gets a fresh storage, the GPU keeps reading the previous one
+        glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(_sizePerFrame), nullptr, GL_STREAM_DRAW);
+        _staging.resize(_sizePerFrame);
+      }
+      glBindBuffer(GL_COPY_WRITE_BUFFER, 0u);
+
+      if (_handle == 0u)
+      {
+        Logger::GetInstance()->error("Cannot create a stream buffer");
+        return false;
+      }
+      return true;
+    }
+
+
+    void StreamBuffer::beginFrame()
+    {
+      _used = 0u;
+      if (!isPersistent()) {
+        return;
+      }
+
+      _region = (_region + 1) % NB_REGIONS;
+      GLsync& fence = _fences[_region];
+      if (fence != nullptr)
+      {
+        // the GPU is NB_REGIONS - 1 frames late: wait for it
+        GLenum result = glClientWaitSync(fence, 0, 0u);
+        if (result == GL_TIMEOUT_EXPIRED)
+        {
+          ++_nbStalls;
+          do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000u);  // 1 ms
+          } while (result == GL_TIMEOUT_EXPIRED);
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+      }
+    }
+
+
+    StreamBuffer::Allocation StreamBuffer::allocate(const std::size_t size, std::size_t alignment)
+    {
+      if (alignment == 0u) {
+        alignment = _alignment;
+      }
+      const std::size_t begin = (_used + alignment - 1u) / alignment * alignment;
+      if (begin + size > _sizePerFrame)
+      {
+        Logger::GetInstance()->error("Stream buffer: " + std::to_string(_sizePerFrame) + " bytes per frame exceeded");
+        return {};
+      }
+      _used = begin + size;
+
+      Allocation allocation;
+      allocation.size = size;
+      if (isPersistent())
+      {
+        const std::size_t offset = std::size_t(_region) * _sizePerFrame + begin;
+        allocation.pData = _pMapped + offset;
+        allocation.offset = static_cast<GLintptr>(offset);
+      }
+      else
+      {
+        allocation.pData = _staging.data() + begin;
+        allocation.offset = static_cast<GLintptr>(begin);
+      }
+      return allocation;
+    }
+
+
+    void StreamBuffer::flush()
+    {
+      if (isPersistent() || _used == 0u) {
+        return;  // coherent mapping: nothing to do
+      }
+      glBindBuffer(GL_COPY_WRITE_BUFFER, _handle);
+      glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(_sizePerFrame), nullptr, GL_STREAM_DRAW);
+      glBufferSubData(GL_COPY_WRITE_BUFFER, 0, static_cast<GLsizeiptr>(_used), _staging.data());
+      glBindBuffer(GL_COPY_WRITE_BUFFER, 0u);
+    }
+
+
+    void StreamBuffer::endFrame()
+    {
+      if (isPersistent()) {
+        _fences[_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+      }
+    }
+
+
+    void StreamBuffer::bindRange(const GLuint index, const Allocation& allocation) const
+    {
+      glBindBufferRange(_target, index, _handle, allocation.offset, static_cast<GLsizeiptr>(allocation.size));
+    }
+
+
+    void StreamBuffer::release()
+    {
+      for (auto& fence : _fences)
+      {
+        if (fence != nullptr)
+        {
+          glDeleteSync(fence);
+          fence = nullptr;
+        }
+      }
+      if (_pMapped != nullptr)
+      {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, _handle);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0u);
+        _pMapped = nullptr;
+      }
+      _handle.reset();
+      _staging.clear();
+      _staging.shrink_to_fit();
+    }
+
+  } // opengl
+
+} // helpers
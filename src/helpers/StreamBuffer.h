@@ -0,0 +1,126 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "GlHandle.h"
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    /// @brief Buffer for the data streamed to the GPU every frame: dynamic geometry, uniforms...
+    /// @details If ARB_buffer_storage is available, the buffer is split in NB_REGIONS regions, persistently
+    ///          mapped. Each frame writes in the next region, after waiting for the fence placed the last time
+    ///          it was used. The CPU runs at most NB_REGIONS - 1 frames ahead of the GPU and never waits otherwise.
+    ///          On OpenGL 3.3, the data is written in system memory and uploaded by flush() in an orphaned buffer.
+    ///
+    ///          Usage, once per frame:
+    ///          @code
+    ///          stream.beginFrame();
+    ///          auto alloc = stream.allocate(size);  // as many as needed
+    ///          std::memcpy(alloc.pData, data, size);
+    ///          stream.flush();                       // before the draw calls reading the data
+    ///          ... draw using alloc.offset ...
+    ///          stream.endFrame();
+    ///          @endcode
+    class StreamBuffer
+    {
+    public:
+
+      static constexpr int NB_REGIONS = 3;
+
+      /// @brief A range of the buffer, valid until endFrame()
+      struct Allocation
+      {
+        void*       pData = nullptr;  ///< Where to write
+        GLintptr    offset = 0;       ///< Offset in the buffer, for the draw calls
+        std::size_t size = 0u;
+
+        inline bool isValid() const { return pData != nullptr; }
+      };
+
+      StreamBuffer() = default;
+      StreamBuffer(const StreamBuffer&) = delete;
+      ~StreamBuffer();
+
+      StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+      /// @brief Allocates the buffer
+      /// @param target GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_UNIFORM_BUFFER...
+      /// @param sizePerFrame Maximum amount of data written per frame
+      bool init(const GLenum target, const std::size_t sizePerFrame);
+
+      /// @brief Moves to the next region, waiting for the GPU if it still reads it
+      void beginFrame();
+
+      /// @brief Sub-allocates in the region of the current frame
+      /// @param alignment Alignment of the offset. 0 for the default of the target:
+      ///        GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT for uniforms, 16 otherwise.
+      /// @return An invalid allocation if the region is full
+      Allocation allocate(const std::size_t size, std::size_t alignment = 0u);
+
+      /// @brief Makes the data written visible to the following draw calls
+      void flush();
+
+      /// @brief Fences the region: it is not written again until the GPU is done with it
+      void endFrame();
+
+      /// @brief Binds an allocation to an indexed target, ie a uniform block binding point
+      void bindRange(const GLuint index, const Allocation& allocation) const;
+
+      inline GLuint handle() const { return _handle; }
+      inline std::size_t sizePerFrame() const { return _sizePerFrame; }
+      inline bool isPersistent() const { return _pMapped != nullptr; }
+      /// @brief Number of times beginFrame() had to wait for the GPU
+      inline std::uint64_t nbStalls() const { return _nbStalls; }
+
+    private:
+
+      void release();
+
+      GLenum      _target = GL_ARRAY_BUFFER;
+      BufferHandle _handle;
+      std::size_t _sizePerFrame = 0u;
+      std::size_t _alignment = 16u;
+      std::size_t _used = 0u;             ///< In the current region
+      int         _region = 0;
+      unsigned char* _pMapped = nullptr;  ///< Persistent mapping of the whole buffer
+      std::vector<unsigned char> _staging;  ///< Without persistent mapping
+      std::array<GLsync, NB_REGIONS> _fences{};
+      std::uint64_t _nbStalls = 0u;
+    };
+
+  } // opengl
+
+} // helpers
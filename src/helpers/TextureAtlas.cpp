@@ -0,0 +1,286 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <algorithm>
+#include <cassert>
+
+#include <stb/stb_image.h>
+
+#include "Logger.h"
+#include "StateCache.h"
+#include "TextureAtlas.h"
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    TextureAtlas::TextureAtlas(const int pageSize)
+      : _pageSize{ pageSize }
+      , _worker{
+          [this]()
+          {
+            stbi_set_flip_vertically_on_load_thread(0); // ImGui's UVs are top to bottom
+            for (auto job = _jobs.pop_front(); !job.isStop; job = _jobs.pop_front())
+            {
+              Decoded decoded;
+              decoded.id = job.id;
+              unsigned char* imageData = stbi_load(job.path.string().c_str(), &decoded.width, &decoded.height, nullptr, 4);
+              if (imageData != nullptr) {
+                decoded.pixels.assign(imageData, imageData + std::size_t(decoded.width) * std::size_t(decoded.height) * 4u);
+              }
+              else {
+                decoded.error = "Cannot load image " + job.path.string();
+              }
+              stbi_image_free(imageData);
+
+              std::lock_guard<std::mutex> lock{ _mutexDecoded };
+              _decoded.emplace_back(std::move(decoded));
+            }
+          }
+        }
+    {}
+
+
+    TextureAtlas::~TextureAtlas()
+    {
+      Job stop;
+      stop.isStop = true;
+      _jobs.emplace_back(std::move(stop));
+      _worker.join();
+    }
+
+
+    TextureAtlas::Id TextureAtlas::add(const std::filesystem::path& path)
+    {
+      const Id id = _regions.size();
+      _regions.emplace_back();
+      if (path.empty())
+      {
+        Logger::GetInstance()->error("Cannot load an image without a path");
+        return id;
+      }
+      _jobs.emplace_back(Job{ id, path });
+      return id;
+    }
+
+
+    TextureAtlas::Id TextureAtlas::add(const unsigned char* pixels, const int width, const int height)
+    {
+      const Id id = _regions.size();
+      _regions.emplace_back();
+      place(id, pixels, width, height);
+      return id;
+    }
+
+
+    void TextureAtlas::update()
+    {
+      std::vector<Decoded> decoded;
+      {
+        std::lock_guard<std::mutex> lock{ _mutexDecoded };
+        decoded.swap(_decoded);
+      }
+
+      // packing the tallest images first gives a tighter skyline
+      std::sort(decoded.begin(), decoded.end(),
+        [](const Decoded& lhs, const Decoded& rhs) { return lhs.height > rhs.height; }
+      );
+
+      for (const auto& image : decoded)
+      {
+        if (!image.error.empty()) {
+          Logger::GetInstance()->error(image.error);
+          continue;
+        }
+        place(image.id, image.pixels.data(), image.width, image.height);
+      }
+    }
+
+
+    void TextureAtlas::place(const Id id, const unsigned char* pixels, const int width, const int height)
+    {
+      if (width + PADDING > _pageSize || height + PADDING > _pageSize)
+      {
+        Logger::GetInstance()->error("Image is too large for the atlas: "
+          + std::to_string(width) + 'x' + std::to_string(height));
+        return;
+      }
+
+      // first page with enough room, or a new one
+      int x = 0;
+      int y = 0;
+      Page* pPage = nullptr;
+      for (auto& page : _pages)
+      {
+        if (pack(page, width + PADDING, height + PADDING, x, y)) {
+          pPage = &page;
+          break;
+        }
+      }
+      if (pPage == nullptr)
+      {
+        pPage = &addPage();
+        const bool packed = pack(*pPage, width + PADDING, height + PADDING, x, y);
+        assert(packed);
+        (void)packed;
+      }
+
+      StateCache::GetInstance().bindTexture(pPage->handle);
+      glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+      glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+      const float size = float(_pageSize);
+      auto& region = _regions[id];
+      region.page = pPage->handle;
+      region.u0 = float(x) / size;
+      region.v0 = float(y) / size;
+      region.u1 = float(x + width) / size;
+      region.v1 = float(y + height) / size;
+      region.width = width;
+      region.height = height;
+    }
+
+
+    TextureAtlas::Page& TextureAtlas::addPage()
+    {
+      Page page;
+      page.skyline.push_back({ 0, 0, _pageSize });
+
+      // cleared once, so that the padding stays transparent
+      const std::vector<unsigned char> blank(std::size_t(_pageSize) * std::size_t(_pageSize) * 4u, 0u);
+      page.handle = TextureHandle::Create();
+      StateCache::GetInstance().bindTexture(page.handle);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+      glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, _pageSize, _pageSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, blank.data());
+
+      Logger::GetInstance()->debug("Texture atlas: new page #" + std::to_string(_pages.size()));
+      _pages.emplace_back(std::move(page));
+      return _pages.back();
+    }
+
+
+    bool TextureAtlas::fits(const Page& page, std::size_t i, const int width, const int height, int& y) const
+    {
+      const int x = page.skyline[i].x;
+      if (x + width > _pageSize) {
+        return false;
+      }
+
+      y = page.skyline[i].y;
+      int widthLeft = width;
+      while (widthLeft > 0)
+      {
+        if (i == page.skyline.size()) {
+          return false;
+        }
+        y = std::max(y, page.skyline[i].y);
+        if (y + height > _pageSize) {
+          return false;
+        }
+        widthLeft -= page.skyline[i].width;
+        ++i;
+      }
+      return true;
+    }
+
+
+    bool TextureAtlas::pack(Page& page, const int width, const int height, int& x, int& y) const
+    {
+      // bottom-left heuristic: lowest top edge, then narrowest node
+      int bestBottom = _pageSize + 1;
+      int bestWidth = _pageSize + 1;
+      std::size_t bestIndex = page.skyline.size();
+
+      for (std::size_t i = 0u; i < page.skyline.size(); ++i)
+      {
+        int top = 0;
+        if (!fits(page, i, width, height, top)) {
+          continue;
+        }
+        const auto& node = page.skyline[i];
+        if (top + height < bestBottom || (top + height == bestBottom && node.width < bestWidth))
+        {
+          bestIndex = i;
+          bestBottom = top + height;
+          bestWidth = node.width;
+          x = node.x;
+          y = top;
+        }
+      }
+
+      if (bestIndex == page.skyline.size()) {
+        return false;
+      }
+
+      addSkylineLevel(page, bestIndex, x, y, width, height);
+      return true;
+    }
+
+
+    void TextureAtlas::addSkylineLevel(Page& page, const std::size_t i, const int x, const int y, const int width, const int height) const
+    {
+      auto& skyline = page.skyline;
+      skyline.insert(skyline.begin() + i, SkylineNode{ x, y + height, width });
+
+      // shrink or remove the nodes now covered by the new one
+      for (std::size_t j = i + 1u; j < skyline.size(); )
+      {
+        const auto& previous = skyline[j - 1u];
+        const int previousEnd = previous.x + previous.width;
+        if (skyline[j].x >= previousEnd) {
+          break;
+        }
+        const int shrink = previousEnd - skyline[j].x;
+        skyline[j].x += shrink;
+        skyline[j].width -= shrink;
+        if (skyline[j].width > 0) {
+          break;
+        }
+        skyline.erase(skyline.begin() + j);
+      }
+
+      // merge the neighbours at the same height
+      for (std::size_t j = 0u; j + 1u < skyline.size(); )
+      {
+        if (skyline[j].y == skyline[j + 1u].y)
+        {
+          skyline[j].width += skyline[j + 1u].width;
+          skyline.erase(skyline.begin() + j + 1u);
+        }
+        else {
+          ++j;
+        }
+      }
+    }
+
+  } // opengl
+
+} // helpers
@@ -0,0 +1,154 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#pragma once
+
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "GlHandle.h"
+#include "TDequeConcurrent.h"
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    /// @brief Packs many small RGBA images into a few large textures ("pages")
+    /// @details Images drawn from the same page share a single texture binding,
+    ///          so ImGui can batch them into the same draw command.
+    ///          Image files are decoded on a background thread, then packed
+    ///          (skyline bottom-left) and uploaded by update() on the OpenGl thread.
+    ///          A new page is allocated whenever an image does not fit the existing ones.
+    class TextureAtlas
+    {
+    public:
+
+      static constexpr int DEFAULT_PAGE_SIZE = 2048;
+      static constexpr int PADDING = 1; ///< Empty texels between two images, to avoid bleeding
+
+      using Id = std::size_t;
+
+      /// @brief Location of an image in the atlas
+      struct Region
+      {
+        GLuint page = 0u;   ///< Handle of the texture containing the image, 0 if not available yet
+        float u0 = 0.f;     ///< Top left UV
+        float v0 = 0.f;
+        float u1 = 0.f;     ///< Bottom right UV
+        float v1 = 0.f;
+        int width = 0;
+        int height = 0;
+
+        inline bool isValid() const { return page != 0u; }
+      };
+
+      TextureAtlas(const int pageSize = DEFAULT_PAGE_SIZE);
+      TextureAtlas(const TextureAtlas&) = delete;
+      ~TextureAtlas();
+
+      TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+      /// @brief Queues an image file to be decoded in the background
+      /// @return The id of the region, valid once update() has packed the image.
+      ///         The region of an empty path is never valid.
+      Id add(const std::filesystem::path& path);
+
+      /// @brief Packs and uploads RGBA pixels right away. Must be called on the OpenGl thread.
+      Id add(const unsigned char* pixels, const int width, const int height);
+
+      /// @brief Packs and uploads the images decoded since the last call
+      /// @details Must be called on the OpenGl thread, typically once per frame
+      void update();
+
+      /// @brief Returns the location of an image. The region is not valid until the image is packed.
+      /// @details The reference is invalidated by the next call to add()
+      const Region& region(const Id id) const { return _regions[id]; }
+
+      inline std::size_t nbPages() const { return _pages.size(); }
+      inline std::size_t nbRegions() const { return _regions.size(); }
+      inline int pageSize() const { return _pageSize; }
+
+    private:
+
+      struct SkylineNode
+      {
+        int x;
+        int y;
+        int width;
+      };
+
+      struct Page
+      {
+        TextureHandle handle;
+        std::vector<SkylineNode> skyline;
+      };
+
+      struct Decoded
+      {
+        Id id;
+        int width = 0;
+        int height = 0;
+        std::vector<unsigned char> pixels;
+        std::string error;
+      };
+
+      struct Job
+      {
+        Id id = 0u;
+        std::filesystem::path path;
+        bool isStop = false;  ///< Stops the worker
+      };
+
+      /// @brief Finds a place in a page and uploads the pixels
+      void place(const Id id, const unsigned char* pixels, const int width, const int height);
+      /// @brief Allocates a new empty page
+      Page& addPage();
+      /// @brief Skyline bottom-left packing
+      /// @return false if the rectangle does not fit in the page
+      bool pack(Page& page, const int width, const int height, int& x, int& y) const;
+      /// @brief Returns true if a rectangle fits on the skyline starting at node i, and its vertical position
+      bool fits(const Page& page, std::size_t i, const int width, const int height, int& y) const;
+      void addSkylineLevel(Page& page, const std::size_t i, const int x, const int y, const int width, const int height) const;
+
+      const int _pageSize;
+      std::vector<Page>   _pages;
+      std::vector<Region> _regions;
+
+      // background decoding
+      TDequeConcurrent<Job> _jobs;
+      std::mutex            _mutexDecoded;
+      std::vector<Decoded>  _decoded;
+      std::thread           _worker;
+    };
+
+  } // opengl
+
+} // helpers
@@ -0,0 +1,123 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <iterator>
+
+#include "HelpersOpenGl.h"
+#include "TextureResidency.h"
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    TextureResidency TextureResidency::_Instance;
+
+
+    void TextureResidency::setBudget(const std::size_t bytes)
+    {
+      std::lock_guard<std::recursive_mutex> lock{ _mutex };
+      _budget = bytes;
+      enforceBudget();
+    }
+
+
+    void TextureResidency::onLoaded(Texture* pTexture)
+    {
+      std::lock_guard<std::recursive_mutex> lock{ _mutex };
+      if (!_textures.insert(pTexture).second) {
+        ++_nbReloads;
+      }
+      _lru.push_front(pTexture);
+      _entries[pTexture] = Entry{ _lru.begin(), _frame };
+      _usage += pTexture->sizeInBytes();
+
+      enforceBudget();
+    }
+
+
+    void TextureResidency::onEvicted(Texture* pTexture)
+    {
+      std::lock_guard<std::recursive_mutex> lock{ _mutex };
+      const auto it = _entries.find(pTexture);
+      if (it == _entries.end()) {
+        return;
+      }
+      _lru.erase(it->second.it);
+      _entries.erase(it);
+      _usage -= pTexture->sizeInBytes();
+    }
+
+
+    void TextureResidency::onDestroyed(Texture* pTexture)
+    {
+      std::lock_guard<std::recursive_mutex> lock{ _mutex };
+      onEvicted(pTexture);
+      _textures.erase(pTexture);
+    }
+
+
+    void TextureResidency::touch(Texture* pTexture)
+    {
+      std::lock_guard<std::recursive_mutex> lock{ _mutex };
+      const auto it = _entries.find(pTexture);
+      if (it == _entries.end()) {
+        return;
+      }
+      it->second.frame = _frame;
+      if (it->second.it != _lru.begin()) {
+        _lru.splice(_lru.begin(), _lru, it->second.it);
+      }
+    }
+
+
+    void TextureResidency::newFrame()
+    {
+      std::lock_guard<std::recursive_mutex> lock{ _mutex };
+      ++_frame;
+      enforceBudget();  // what the previous frame kept over the budget
+    }
+
+
+    void TextureResidency::enforceBudget()
+    {
+      if (_budget == NO_BUDGET) {
+        return;
+      }
+
+      while (_usage > _budget && !_lru.empty())
+      {
+        Texture* pOldest = _lru.back();
+        if (_entries[pOldest].frame == _frame) {
+          break; // all the resident textures are in use by this frame
+        }
+        pOldest->evict(); // calls onEvicted()
+        ++_nbEvictions;
+      }
+    }
+
+  } // opengl
+
+} // helpers
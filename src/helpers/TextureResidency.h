@@ -0,0 +1,121 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    class Texture;
+
+    /// @brief Keeps track of the video memory used by the textures
+    /// @details The textures register themselves when loaded. When the budget is exceeded,
+    ///          the least recently bound textures are evicted. They will be reloaded from
+    ///          their file when bound again.
+    ///          The textures bound during the current frame are never evicted, as a draw may still use them:
+    ///          the budget can be exceeded until the next frame.
+    ///          A texture can be destroyed on any thread: the bookkeeping is synchronized and
+    ///          its OpenGL object is deleted by the DeletionQueue.
+    class TextureResidency
+    {
+    public:
+
+      static constexpr std::size_t NO_BUDGET = 0u;
+
+      static TextureResidency& GetInstance() {
+        return _Instance;
+      }
+
+      /// @brief Sets the maximum amount of video memory the textures can occupy
+      /// @details Set to NO_BUDGET to deactivate
+      void setBudget(const std::size_t bytes);
+      inline std::size_t budget() const { return _budget; }
+
+      /// @brief Video memory currently occupied by the resident textures
+      inline std::size_t usage() const { return _usage; }
+      inline std::size_t nbResident() const { return _lru.size(); }
+      inline std::size_t nbTextures() const { return _textures.size(); }
+      inline std::uint64_t nbEvictions() const { return _nbEvictions; }
+      inline std::uint64_t nbReloads() const { return _nbReloads; }
+
+      /// @brief Calls fct(const Texture&) on each resident texture, from the most to the least recently used
+      template<typename F>
+      void forEachResident(F&& fct) const
+      {
+        std::lock_guard<std::recursive_mutex> lock{ _mutex };
+        for (const Texture* pTexture : _lru) {
+          fct(*pTexture);
+        }
+      }
+
+      /// @brief Called by a texture when it has been uploaded to the video memory
+      void onLoaded(Texture* pTexture);
+      /// @brief Called by a texture when its video memory has been freed
+      void onEvicted(Texture* pTexture);
+      /// @brief Called by a texture on destruction
+      void onDestroyed(Texture* pTexture);
+      /// @brief Marks a resident texture as the most recently used
+      void touch(Texture* pTexture);
+      /// @brief Starts a new frame: the textures bound during the previous one can be evicted
+      void newFrame();
+
+    private:
+
+      /// @brief Evicts the least recently used textures until the budget is met
+      /// @details The textures bound during the current frame are kept
+      void enforceBudget();
+
+      struct Entry
+      {
+        std::list<Texture*>::iterator it;
+        std::uint64_t frame;  ///< Last frame the texture was bound
+      };
+
+      static TextureResidency _Instance;
+
+      mutable std::recursive_mutex _mutex;  ///< Recursive: evicting a texture calls onEvicted()
+
+      std::list<Texture*> _lru;  ///< Resident textures, most recently used first
+      std::unordered_map<const Texture*, Entry> _entries;
+      std::unordered_set<const Texture*> _textures; ///< All the textures loaded at least once and not destroyed
+
+      std::size_t   _budget = NO_BUDGET;
+      std::size_t   _usage = 0u;
+      std::uint64_t _nbEvictions = 0u;
+      std::uint64_t _nbReloads = 0u;
+      std::uint64_t _frame = 0u;
+    };
+
+  } // opengl
+
+} // helpers
@@ -0,0 +1,87 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <string>
+
+#include "Logger.h"
+#include "UniformBuffer.h"
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    UniformBindings UniformBindings::_Instance;
+
+
+    GLuint UniformBindings::bind(const std::string& name, const std::size_t size)
+    {
+      const auto it = _bindings.find(name);
+      if (it != _bindings.end())
+      {
+        if (it->second.size != size) {
+          Logger::GetInstance()->error("Uniform block " + name + " registered with two different sizes");
+        }
+        return it->second.point;
+      }
+
+      GLint maxBindings = 0;
+      glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &maxBindings);
+      const auto point = static_cast<GLuint>(_bindings.size());
+      if (point >= static_cast<GLuint>(maxBindings))
+      {
+        Logger::GetInstance()->error("No uniform buffer binding point left for " + name);
+        return GL_INVALID_INDEX;
+      }
+      _bindings.emplace(name, Binding{ point, size });
+      return point;
+    }
+
+
+    void UniformBindings::apply(const GLuint program, const ProgramResource& block) const
+    {
+      const auto it = _bindings.find(block.name);
+      if (it == _bindings.end()) {
+        return;
+      }
+      if (static_cast<std::size_t>(block.size) > it->second.size)
+      {
+        Logger::GetInstance()->error("Uniform block " + it->first + " is " + std::to_string(block.size)
+          + " bytes in the program but " + std::to_string(it->second.size) + " in C++");
+        return;
+      }
+      glUniformBlockBinding(program, static_cast<GLuint>(block.location), it->second.point);
+    }
+
+
+    GLuint UniformBindings::bindingPoint(std::string_view name) const
+    {
+      const auto it = _bindings.find(name);
+      return it != _bindings.end() ? it->second.point : GL_INVALID_INDEX;
+    }
+
+  } // opengl
+
+} // helpers
@@ -0,0 +1,180 @@
+//MIT License
+//
+//Copyright(c) 2024
+//Christophe Meneboeuf <christophe@xtof.info>
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files(the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions :
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "ProgramResources.h"
+#include "StreamBuffer.h"
+
+
+/// @brief Checks at compile time that a member of a uniform block is where std140 puts it
+/// @details The offsets are the ones of the GLSL declaration, computed with the std140 rules
+#define HELPERS_STD140_OFFSET(Block, member, offset) \
+  static_assert(offsetof(Block, member) == (offset), #Block "::" #member " is not at the std140 offset " #offset)
+
+
+namespace helpers
+{
+
+  namespace opengl
+  {
+
+    /// @brief C++ types laid out as their GLSL counterparts in a std140 uniform block
+    /// @details A vec3 occupies 16 bytes: std140 allows to pack a scalar right after it,
+    ///          these types do not. Declare a vec3 before a vec4 or pad it in the GLSL.
+    ///          The elements of an array are aligned on 16 bytes, whatever their type.
+    namespace std140
+    {
+      template<typename T, std::size_t Alignment>
+      struct alignas(Alignment) Aligned
+      {
+        T value{};
+
+        Aligned() = default;
+        Aligned(const T& v) : value{ v } {}
+        inline Aligned& operator=(const T& v) { value = v; return *this; }
+        inline operator const T&() const { return value; }
+      };
+
+      using Float = float;
+      using Int = std::int32_t;
+      using UInt = std::uint32_t;
+      using Bool = std::uint32_t;   ///< A GLSL bool occupies 4 bytes
+      using Vec2 = Aligned<glm::vec2, 8u>;
+      using Vec3 = Aligned<glm::vec3, 16u>;
+      using Vec4 = Aligned<glm::vec4, 16u>;
+      using Mat4 = Aligned<glm::mat4, 16u>;
+      template<typename T, std::size_t N>
+      using Array = std::array<Aligned<T, 16u>, N>;
+
+      static_assert(sizeof(Vec2) == 8u && sizeof(Vec3) == 16u && sizeof(Vec4) == 16u, "std140 vector sizes");
+      static_assert(sizeof(Mat4) == 64u, "std140 mat4 is four vec4 columns");
+      static_assert(sizeof(Array<float, 4u>) == 64u, "std140 array stride is rounded to a vec4");
+    }
+
+
+    /// @brief True if Block can be memcpy'ed into a std140 uniform block
+    template<typename Block>
+    inline constexpr bool IsStd140Block = std::is_standard_layout_v<Block>
+                                       && std::is_trivially_copyable_v<Block>
+                                       && sizeof(Block) % 16u == 0u;
+
+
+    /// @brief Binding points of the uniform blocks, shared by all the programs
+    /// @details Each block name gets a binding point once. After linking, Program binds its
+    ///          blocks to the points registered for their names: a buffer bound to a point
+    ///          feeds the block in every program declaring it.
+    class UniformBindings
+    {
+    public:
+
+      static UniformBindings& GetInstance() { return _Instance; }
+
+      /// @brief Returns the binding point of a block, assigning one the first time
+      /// @param size Size of the block in bytes, checked against the programs declaring it
+      /// @return GL_INVALID_INDEX if there are no binding points left
+      GLuint bind(const std::string& name, const std::size_t size);
+
+      /// @brief Binds an active uniform block of a program to the point registered for its name
+      void apply(const GLuint program, const ProgramResource& block) const;
+
+      /// @return GL_INVALID_INDEX if the block is not registered
+      GLuint bindingPoint(std::string_view name) const;
+
+    private:
+
+      UniformBindings() = default;
+
+      struct Binding
+      {
+        GLuint point;
+        std::size_t size;
+      };
+
+      std::map<std::string, Binding, std::less<>> _bindings;
+
+      static UniformBindings _Instance;
+    };
+
+
+    /// @brief A uniform block shared by all the programs, uploaded once per frame
+    /// @details Block is a C++ struct matching the std140 layout of the GLSL block:
+    ///          build it from the std140 types and check its offsets with HELPERS_STD140_OFFSET.
+    ///          The data goes through a StreamBuffer: updating it does not wait for the GPU
+    ///          still drawing the previous frames.
+    template<typename Block>
+    class UniformBuffer
+    {
+      static_assert(IsStd140Block<Block>, "A uniform block must be trivially copyable and padded to a multiple of 16 bytes");
+
+    public:
+
+      /// @param name Name of the block in the GLSL sources
+      bool init(const std::string& name)
+      {
+        _bindingPoint = UniformBindings::GetInstance().bind(name, sizeof(Block));
+        return _bindingPoint != GL_INVALID_INDEX && _stream.init(GL_UNIFORM_BUFFER, sizeof(Block));
+      }
+
+      /// @brief Uploads the block and binds it, for all the draw calls until the next update
+      /// @details To be called once per frame, before drawing
+      void update(const Block& data)
+      {
+        if (_isUpdated) {
+          _stream.endFrame();   // the previous frame has been submitted
+        }
+        _stream.beginFrame();
+        const auto allocation = _stream.allocate(sizeof(Block));
+        _isUpdated = allocation.isValid();
+        if (!_isUpdated) {
+          return;
+        }
+        std::memcpy(allocation.pData, &data, sizeof(Block));
+        _stream.flush();
+        _stream.bindRange(_bindingPoint, allocation);
+      }
+
+      inline GLuint bindingPoint() const { return _bindingPoint; }
+
+    private:
+
+      StreamBuffer _stream;
+      GLuint _bindingPoint = GL_INVALID_INDEX;
+      bool   _isUpdated = false;
+    };
+
+  } // opengl
+
+} // helpers